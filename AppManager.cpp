@@ -6,14 +6,20 @@
 
 #include "TextLoader.h"
 #include "DatasetUtils.h"
+#include "ModelCheckpoint.h"
+#include "ScoringServer.h"
+#include "BulkClassifier.h"
 #include "neural_network.h"
 #include "nn_dense.h"
 #include "nn_activation.h"
 #include "nn_loss.h"
 #include "tensor.h"
+#include <chrono>
 #include <iostream>
 #include <iomanip>
 #include <memory>
+#include <numeric>
+#include <stdexcept>
 
 using namespace std;
 using namespace utec::app;
@@ -29,12 +35,19 @@ namespace {
     // agregar: opcion de escoger entre:
     // - training_words_esp.csv
     // - training_words_eng.csv
+    // Para ancho fijo sin vocabulario: TextLoader(archivo, HashingConfig{bits, n-gramas})
     TextLoader loader("training_words_eng.csv");
 
 
+    // Checkpoint con los pesos y el vocabulario, para no reentrenar en cada inicio
+    const string model_path = "spam_model.bin";
+
     size_t input_size = 0;
     bool model_trained = false;
 
+    // Misma división (índices) para entrenar y evaluar
+    DatasetSplit split;
+
     void build_model() {
         model = NeuralNetwork<float>(); // reset del modelo
         model.add_layer(make_unique<Dense<float>>(input_size, 16,
@@ -45,7 +58,9 @@ namespace {
         model.add_layer(make_unique<Dense<float>>(16, 1,
             [](utec::algebra::Tensor<float, 2>& W) { W.fill(0.01f); },  // pesos
             [](utec::algebra::Tensor<float, 2>& b) { b.fill(0.0f); })); // bias
-        model.add_layer(make_unique<Sigmoid<float>>());
+        // Sin Sigmoid final: la red entrega logits y SigmoidBCEWithLogits aplica
+        // la sigmoide junto con la pérdida. logit >= 0 equivale a probabilidad >= 0.5
+        model.fuse_layers(); // la ReLU pasa a aplicarse dentro de la primera Dense
     }
 }
 
@@ -59,6 +74,8 @@ void AppManager::show_menu() {
         cout << "2. Probar IA" << endl;
         cout << "3. Predecir mensaje" << endl;
         cout << "4. Ejecutar tests" << endl;
+        cout << "5. Guardar modelo" << endl;
+        cout << "6. Cargar modelo" << endl;
         cout << "0. Salir" << endl;
         cout << "Seleccione una opcion: ";
         cin >> option;
@@ -69,6 +86,8 @@ void AppManager::show_menu() {
             case 2: test_model(); break;
             case 3: predict_message(); break;
             case 4: run_tests(); break;
+            case 5: save_model(); break;
+            case 6: load_model(); break;
             case 0: cout << "Saliendo..." << endl; break;
             default: cout << "Opcion invalida" << endl; break;
         }
@@ -80,17 +99,25 @@ void AppManager::train_model() {
     cout << "\Cargando datos y entrenando IA..." << endl;
 
     loader.load_data();
-    input_size = loader.get_vocabulary_size();
+    input_size = loader.get_feature_size();
 
-    vector<TextExample> train_set, test_set;
-    DatasetUtils::split_dataset(loader.get_dataset(), train_set, test_set);
+    const auto& dataset = loader.get_dataset();
+    split = DatasetUtils::split_indices(dataset, 0.8f, DatasetUtils::default_seed, true);
 
-    auto X_train = DatasetUtils::vector_to_tensor(train_set);
-    auto Y_train = DatasetUtils::labels_to_tensor(train_set);
+    // Entrada dispersa (CSR): cada mensaje tiene pocas palabras del vocabulario
+    auto X_train = DatasetUtils::vector_to_csr(dataset, split.train);
+    auto Y_train = DatasetUtils::labels_to_tensor(dataset, split.train);
 
     build_model();
+    // Nuevo orden en cada época, sin copiar los datos. Cada época parte de
+    // 0..n-1 con una semilla propia, aparte de las (default_seed, 0..3) del split
+    model.set_epoch_hook([](size_t epoch, vector<size_t>& order) {
+        iota(order.begin(), order.end(), size_t{0});
+        const uint64_t seed = DatasetUtils::default_seed ^ ((epoch + 1) * 0x9E3779B97F4A7C15ull);
+        DatasetUtils::shuffle_indices(order, seed);
+    });
 
-    model.train<BCELoss>(X_train, Y_train, 20, 8, 0.1f);
+    model.train<SigmoidBCEWithLogits>(X_train, Y_train, 20, 8, 0.1f);
 
     model_trained = true;
 
@@ -104,13 +131,15 @@ void AppManager::test_model() {
         return;
     }
 
-    cout << "\nEvaluando modelo..." << endl;
+    if (split.test.empty()) {
+        cout << "El conjunto de prueba sale del entrenamiento: entrene en esta sesion para evaluar." << endl;
+        return;
+    }
 
-    vector<TextExample> train_set, test_set;
-    DatasetUtils::split_dataset(loader.get_dataset(), train_set, test_set);
+    cout << "\nEvaluando modelo..." << endl;
 
-    auto X_test = DatasetUtils::vector_to_tensor(test_set);
-    auto Y_test = DatasetUtils::labels_to_tensor(test_set);
+    auto X_test = DatasetUtils::vector_to_csr(loader.get_dataset(), split.test);
+    auto Y_test = DatasetUtils::labels_to_tensor(loader.get_dataset(), split.test);
 
     auto Y_pred = model.predict(X_test);
 
@@ -118,7 +147,7 @@ void AppManager::test_model() {
     int total = Y_test.shape()[0];
 
     for (int i = 0; i < total; ++i) {
-        float predicted = Y_pred(i, 0) >= 0.5f ? 1.0f : 0.0f;
+        float predicted = Y_pred(i, 0) >= 0.0f ? 1.0f : 0.0f;
         float actual = Y_test(i, 0);
         if (predicted == actual) ++correct;
     }
@@ -141,14 +170,13 @@ void AppManager::predict_message() {
     cin.ignore();
     getline(cin, message);
 
-    auto vectorized = loader.vectorize(message);
-    utec::algebra::Tensor<float, 2> input(2, input_size);
-    for (size_t i = 0; i < input_size; ++i)
-        input(0, i) = vectorized[i];
+    auto vectorized = loader.vectorize_sparse(message);
+    utec::algebra::CsrMatrix<float> input(input_size);
+    input.push_row(vectorized.indices.data(), vectorized.values.data(), vectorized.indices.size());
 
     auto prediction = model.predict(input);
 
-    if (prediction(0, 0) >= 0.5f)
+    if (prediction(0, 0) >= 0.0f)
         cout << "El mensaje es SPAM." << endl;
     else
         cout << "El mensaje NO es SPAM" << endl;
@@ -158,5 +186,73 @@ void AppManager::run_tests() {
     cout << "\nPruebas automaticas no implementadas todavia." << endl;
 }
 
+void AppManager::save_model() {
+    if (!model_trained) {
+        cout << "Primero debe entrenar la IA." << endl;
+        return;
+    }
 
+    try {
+        ModelCheckpoint::save(model_path, model, loader);
+        cout << "Modelo guardado en " << model_path << endl;
+    } catch (const exception& e) {
+        cout << "No se pudo guardar el modelo: " << e.what() << endl;
+    }
+}
+
+void AppManager::load_model() {
+    try {
+        // Pesos leídos directo del archivo proyectado: solo para predecir,
+        // entrenar de nuevo reconstruye el modelo
+        ModelCheckpoint::load(model_path, model, loader);
+        input_size = loader.get_feature_size();
+        split = DatasetSplit{};
+        model_trained = true;
+        cout << "Modelo cargado desde " << model_path << endl;
+    } catch (const exception& e) {
+        cout << "No se pudo cargar el modelo: " << e.what() << endl;
+    }
+}
+
+int AppManager::serve(const string& endpoint, size_t max_batch, size_t max_delay_us) {
+    try {
+        ModelCheckpoint::load(model_path, model, loader);
+        ServerConfig config;
+        config.max_batch = max_batch;
+        config.max_delay = chrono::microseconds(max_delay_us);
+        ScoringServer server(model, loader, config);
+
+        // Los mensajes de estado van a cerr: en modo "-" stdout lleva solo respuestas
+        if (endpoint == "-") {
+            server.serve_stream(0, 1);
+            return 0;
+        }
+        server.listen(endpoint);
+        cerr << "Atendiendo en " << endpoint << " (Ctrl+C para terminar)" << endl;
+        wait_for_shutdown_signal();
+        server.stop();
+        const auto stats = server.stats();
+        cerr << "Mensajes " << stats.requests << " en " << stats.batches << " batches" << endl;
+        return 0;
+    } catch (const exception& e) {
+        cerr << "No se pudo iniciar el servidor: " << e.what() << endl;
+        return 1;
+    }
+}
 
+int AppManager::classify(const string& input, const string& output, bool csv, size_t batch_size, size_t threads) {
+    try {
+        ModelCheckpoint::load(model_path, model, loader);
+        BulkConfig config;
+        config.csv = csv;
+        config.batch_size = batch_size;
+        config.threads = threads;
+        const auto stats = classify_file(input, output, model, loader, config);
+        cerr << fixed << setprecision(2) << "Mensajes " << stats.messages << " en " << stats.seconds << " s ("
+             << static_cast<double>(stats.bytes) / 1e6 / max(stats.seconds, 1e-9) << " MB/s)" << endl;
+        return 0;
+    } catch (const exception& e) {
+        cerr << "No se pudo clasificar: " << e.what() << endl;
+        return 1;
+    }
+}
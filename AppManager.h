@@ -5,16 +5,31 @@
 #ifndef APPMANAGER_H
 #define APPMANAGER_H
 
+#include <cstddef>
+#include <string>
+
 namespace utec::app {
     class AppManager {
     public:
         void show_menu();
 
+        // Modo servidor (`main serve`): carga el modelo guardado y puntúa
+        // mensajes por un socket Unix, o por stdin/stdout si endpoint es "-".
+        // Devuelve el código de salida del proceso
+        int serve(const std::string& endpoint, size_t max_batch, size_t max_delay_us);
+
+        // Clasificación masiva (`main classify`): puntúa cada mensaje de input
+        // con el modelo guardado y escribe los resultados en output ("-" = stdin/stdout)
+        int classify(const std::string& input, const std::string& output, bool csv,
+                     size_t batch_size, size_t threads);
+
     private:
         void train_model();
         void test_model();
         void predict_message();
         void run_tests();
+        void save_model();
+        void load_model();
     };
 }
 
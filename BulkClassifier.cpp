@@ -0,0 +1,253 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#include "BulkClassifier.h"
+#include "ScoringServer.h"
+#include "tensor_sparse.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace utec::app;
+using namespace utec::data;
+using namespace utec::neural_network;
+
+namespace {
+
+    struct Chunk {
+        size_t seq = 0;
+        std::string text;
+    };
+
+    struct Result {
+        std::string text;
+        size_t messages = 0;
+    };
+
+    // Archivo de C con cierre automático; "-" es stdin o stdout
+    struct File {
+        std::FILE* file = nullptr;
+        bool owned = false;
+
+        File(const std::string& path, bool output) {
+            if (path == "-") {
+                file = output ? stdout : stdin;
+                return;
+            }
+            file = std::fopen(path.c_str(), output ? "wb" : "rb");
+            if (!file) throw std::runtime_error("Cannot open " + path);
+            owned = true;
+        }
+        ~File() {
+            if (owned) std::fclose(file);
+        }
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+    };
+
+    // Fin del último registro completo de text (0 si todavía no hay ninguno)
+    size_t record_boundary(std::string_view text, bool csv) {
+        if (!csv) {
+            const size_t newline = text.rfind('\n');
+            return newline == std::string_view::npos ? 0 : newline + 1;
+        }
+        // Un campo entre comillas puede tener saltos de línea: se recorren los
+        // registros y vale solo el que terminó antes del final del bloque (uno
+        // que llega justo al final puede ser una comilla sin cerrar)
+        size_t pos = 0, boundary = 0;
+        std::string_view label, message;
+        while (next_csv_record(text, pos, label, message) && pos < text.size()) boundary = pos;
+        return boundary;
+    }
+
+    void split_messages(std::string_view text, bool csv, std::vector<std::string_view>& messages) {
+        messages.clear();
+        if (csv) {
+            size_t pos = 0;
+            std::string_view label, message;
+            while (next_csv_record(text, pos, label, message)) messages.push_back(message);
+            return;
+        }
+        // Una línea por mensaje, también las vacías: la salida queda alineada con la entrada
+        for (size_t start = 0; start < text.size();) {
+            size_t end = text.find('\n', start);
+            if (end == std::string_view::npos) end = text.size();
+            std::string_view line = text.substr(start, end - start);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            messages.push_back(line);
+            start = end + 1;
+        }
+    }
+
+}
+
+BulkStats utec::app::classify_file(const std::string& input, const std::string& output,
+                                   const NeuralNetwork<float>& model, const TextLoader& loader,
+                                   const BulkConfig& config) {
+    if (config.batch_size == 0 || config.chunk_bytes == 0)
+        throw std::invalid_argument("Batch size and chunk size must be positive");
+    const auto start = std::chrono::steady_clock::now();
+    File in(input, false);
+    File out(output, true);
+
+    const size_t workers = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t max_in_flight = 2 * workers;
+
+    std::mutex mutex;
+    std::condition_variable work_ready, result_ready, slot_free;
+    std::deque<Chunk> work;
+    std::map<size_t, Result> results; // bloques terminados que esperan su turno de escritura
+    size_t in_flight = 0, total_chunks = 0;
+    bool input_done = false, failed = false;
+    std::exception_ptr error;
+    size_t bytes = 0;
+
+    auto fail = [&](std::exception_ptr e) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = e;
+            failed = true;
+        }
+        work_ready.notify_all();
+        result_ready.notify_all();
+        slot_free.notify_all();
+    };
+
+    // Lector: bloques cortados en el último registro completo; el resto pasa al siguiente
+    std::thread reader([&] {
+        try {
+            std::string buffer;
+            size_t seq = 0;
+            bool header = config.csv, eof = false;
+            while (!eof) {
+                const size_t old = buffer.size();
+                buffer.resize(old + config.chunk_bytes);
+                const size_t n = std::fread(buffer.data() + old, 1, config.chunk_bytes, in.file);
+                buffer.resize(old + n);
+                if (n < config.chunk_bytes) {
+                    if (std::ferror(in.file)) throw std::runtime_error("Cannot read " + input);
+                    eof = true;
+                }
+                bytes += n;
+
+                const size_t end = eof ? buffer.size() : record_boundary(buffer, config.csv);
+                if (end == 0) continue; // registro más largo que un bloque: se sigue leyendo
+                Chunk chunk{seq, std::move(buffer)};
+                buffer.assign(chunk.text, end, std::string::npos);
+                chunk.text.resize(end);
+                if (header) { // la cabecera del CSV no es un mensaje
+                    size_t pos = 0;
+                    std::string_view label, message;
+                    next_csv_record(chunk.text, pos, label, message);
+                    chunk.text.erase(0, pos);
+                    header = false;
+                }
+                if (chunk.text.empty()) continue;
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    slot_free.wait(lock, [&] { return failed || in_flight < max_in_flight; });
+                    if (failed) return;
+                    ++in_flight;
+                    work.push_back(std::move(chunk));
+                    ++seq;
+                }
+                work_ready.notify_one();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                input_done = true;
+                total_chunks = seq;
+            }
+            work_ready.notify_all();
+            result_ready.notify_all();
+        } catch (...) {
+            fail(std::current_exception());
+        }
+    });
+
+    // Workers: tokenizan, vectorizan y puntúan un bloque entero en batches de batch_size
+    std::vector<std::thread> scorers;
+    for (size_t w = 0; w < workers; ++w)
+        scorers.emplace_back([&] {
+            try {
+                std::vector<std::string_view> messages;
+                char reply[32];
+                while (true) {
+                    Chunk chunk;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        work_ready.wait(lock, [&] { return failed || !work.empty() || input_done; });
+                        if (failed || work.empty()) return;
+                        chunk = std::move(work.front());
+                        work.pop_front();
+                    }
+                    split_messages(chunk.text, config.csv, messages);
+                    Result result;
+                    result.messages = messages.size();
+                    result.text.reserve(messages.size() * 16);
+                    for (size_t b = 0; b < messages.size(); b += config.batch_size) {
+                        const size_t e = std::min(messages.size(), b + config.batch_size);
+                        CsrMatrix<float> batch(loader.get_feature_size());
+                        for (size_t i = b; i < e; ++i) {
+                            const auto v = loader.vectorize_sparse(messages[i]);
+                            batch.push_row(v.indices.data(), v.values.data(), v.indices.size());
+                        }
+                        const auto scores = model.predict(batch);
+                        for (size_t i = b; i < e; ++i)
+                            result.text.append(reply, format_score(scores(i - b, 0), config.logits, reply));
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        results.emplace(chunk.seq, std::move(result));
+                    }
+                    result_ready.notify_one();
+                }
+            } catch (...) {
+                fail(std::current_exception());
+            }
+        });
+
+    // Escritor (este hilo): cada bloque en el orden de la entrada
+    size_t messages = 0;
+    for (size_t next = 0;; ++next) {
+        Result result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            result_ready.wait(lock, [&] {
+                return failed || results.count(next) || (input_done && next == total_chunks);
+            });
+            auto it = results.find(next);
+            if (failed || it == results.end()) break;
+            result = std::move(it->second);
+            results.erase(it);
+        }
+        if (std::fwrite(result.text.data(), 1, result.text.size(), out.file) != result.text.size()) {
+            fail(std::make_exception_ptr(std::runtime_error("Cannot write " + output)));
+            break;
+        }
+        messages += result.messages;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --in_flight;
+        }
+        slot_free.notify_one();
+    }
+
+    reader.join();
+    for (auto& t : scorers) t.join();
+    if (error) std::rethrow_exception(error);
+    if (std::fflush(out.file) != 0) throw std::runtime_error("Cannot write " + output);
+
+    return {messages, bytes, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+}
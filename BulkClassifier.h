@@ -0,0 +1,44 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef BULKCLASSIFIER_H
+#define BULKCLASSIFIER_H
+
+#include "TextLoader.h"
+#include "neural_network.h"
+#include <cstddef>
+#include <string>
+
+namespace utec::app {
+
+    struct BulkConfig {
+        size_t batch_size = 256;          // filas por predict
+        size_t threads = 0;               // hilos de vectorizado y scoring (0 = todos los núcleos)
+        size_t chunk_bytes = 4 << 20;     // bloque de lectura
+        bool csv = false;                 // CSV label,message con cabecera (como el dataset) en vez de una línea por mensaje
+        bool logits = true;               // la red entrega logits: se escribe sigmoid(z)
+    };
+
+    struct BulkStats {
+        size_t messages = 0;
+        size_t bytes = 0;
+        double seconds = 0;
+    };
+
+    // Clasifica un archivo de mensajes de cualquier tamaño y escribe una línea
+    // "<probabilidad>\t<spam|ham>" por mensaje, en el mismo orden ("-" = stdin/stdout).
+    //
+    // Es un pipeline: un hilo lee bloques de chunk_bytes cortados en un límite
+    // de registro; los workers tokenizan, vectorizan y puntúan cada bloque en
+    // batches de batch_size; el hilo que llama escribe los resultados en orden.
+    // Como mucho hay 2 bloques por worker en vuelo, así la memoria no depende
+    // del tamaño de la entrada. model y loader solo se leen
+    BulkStats classify_file(const std::string& input, const std::string& output,
+                            const utec::neural_network::NeuralNetwork<float>& model,
+                            const utec::data::TextLoader& loader,
+                            const BulkConfig& config = {});
+
+}
+
+#endif //BULKCLASSIFIER_H
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include "TextLoader.h"
+#include "DatasetUtils.h"
+#include "ModelCheckpoint.h"
+#include "neural_network.h"
+#include "nn_dense.h"
+#include "nn_activation.h"
+#include "nn_loss.h"
+
+using namespace utec::data;
+using namespace utec::neural_network;
+
+using clock_type = std::chrono::steady_clock;
+
+double ms_since(clock_type::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+// Misma arquitectura y entrenamiento que AppManager
+NeuralNetwork<float> train_model(TextLoader& loader) {
+    loader.load_data();
+    auto X = DatasetUtils::vector_to_csr(loader.get_dataset());
+    auto Y = DatasetUtils::labels_to_tensor(loader.get_dataset());
+
+    auto init_w = [](Tensor<float, 2>& W) { W.fill(0.01f); };
+    auto init_b = [](Tensor<float, 2>& b) { b.fill(0.0f); };
+    NeuralNetwork<float> model;
+    model.add_layer(std::make_unique<Dense<float>>(loader.get_feature_size(), 16, init_w, init_b));
+    model.add_layer(std::make_unique<ReLU<float>>());
+    model.add_layer(std::make_unique<Dense<float>>(16, 1, init_w, init_b));
+    model.train<SigmoidBCEWithLogits>(X, Y, 20, 8, 0.1f);
+    return model;
+}
+
+// Primera predicción tras el arranque: incluye tocar las páginas de los pesos
+float first_score(const NeuralNetwork<float>& model, TextLoader& loader) {
+    auto v = loader.vectorize_sparse("Congratulations! You won a free ticket, call now");
+    CsrMatrix<float> input(loader.get_feature_size());
+    input.push_row(v.indices.data(), v.values.data(), v.indices.size());
+    return model.predict(input)(0, 0);
+}
+
+// Uso: CheckpointBenchmark [repeticiones de carga]
+int main(int argc, char* argv[]) {
+    const size_t reps = argc > 1 ? std::stoul(argv[1]) : 50;
+    const std::string path = "checkpoint_benchmark.bin";
+    std::cout << std::fixed << std::setprecision(3);
+
+    auto start = clock_type::now();
+    TextLoader loader("training_words_eng.csv");
+    auto model = train_model(loader);
+    const float reference = first_score(model, loader);
+    const double retrain_ms = ms_since(start);
+
+    ModelCheckpoint::save(path, model, loader);
+    std::cout << "Reentrenar desde CSV:  " << std::setw(10) << retrain_ms << " ms\n";
+
+    for (bool mapped : {true, false}) {
+        double total_ms = 0;
+        float score = 0;
+        for (size_t r = 0; r < reps; ++r) {
+            start = clock_type::now();
+            NeuralNetwork<float> restored;
+            TextLoader restored_loader;
+            ModelCheckpoint::load(path, restored, restored_loader, mapped);
+            score = first_score(restored, restored_loader);
+            total_ms += ms_since(start);
+        }
+        const double load_ms = total_ms / static_cast<double>(reps);
+        std::cout << (mapped ? "Cargar checkpoint mmap:" : "Cargar checkpoint copia:")
+                  << std::setw(9) << load_ms << " ms  | speedup " << std::setw(8) << retrain_ms / load_ms
+                  << "x  | mismo score " << (score == reference ? "si" : "NO") << "\n";
+    }
+    std::remove(path.c_str());
+    return 0;
+}
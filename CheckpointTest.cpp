@@ -0,0 +1,151 @@
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <cstdio>
+#include "TextLoader.h"
+#include "DatasetUtils.h"
+#include "ModelCheckpoint.h"
+#include "neural_network.h"
+#include "nn_dense.h"
+#include "nn_activation.h"
+#include "nn_loss.h"
+
+using namespace utec::data;
+using namespace utec::neural_network;
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    std::cout << (condition ? "[OK]    " : "[FALLA] ") << what << "\n";
+    if (!condition) ++failures;
+}
+
+NeuralNetwork<float> build_model(size_t input_size) {
+    std::mt19937 rng(7);
+    std::normal_distribution<float> dist(0.0f, 0.05f);
+    auto init_w = [&](Tensor<float, 2>& W) { for (auto it = W.begin(); it != W.end(); ++it) *it = dist(rng); };
+    auto init_b = [&](Tensor<float, 2>& b) { for (auto it = b.begin(); it != b.end(); ++it) *it = dist(rng); };
+
+    NeuralNetwork<float> model;
+    model.add_layer(std::make_unique<Dense<float>>(input_size, 16, init_w, init_b));
+    model.add_layer(std::make_unique<ReLU<float>>());
+    model.add_layer(std::make_unique<Dense<float>>(16, 1, init_w, init_b));
+    model.add_layer(std::make_unique<Sigmoid<float>>());
+    return model;
+}
+
+bool same_scores(const Tensor<float, 2>& a, const Tensor<float, 2>& b) {
+    if (a.shape() != b.shape()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a.cbegin()[i] != b.cbegin()[i]) return false;
+    return true;
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+// Guarda y recarga un modelo entrenado: las predicciones deben ser idénticas bit a bit
+void round_trip(TextLoader& loader, const std::string& name) {
+    loader.load_data();
+    auto X = DatasetUtils::vector_to_csr(loader.get_dataset());
+    auto Y = DatasetUtils::labels_to_tensor(loader.get_dataset());
+
+    auto model = build_model(loader.get_feature_size());
+    model.train<BCELoss>(X, Y, 1, 64, 0.5f);
+    const auto expected = model.predict(X);
+
+    const std::string path = "checkpoint_test.bin";
+    ModelCheckpoint::save(path, model, loader);
+
+    for (bool mapped : {true, false}) {
+        NeuralNetwork<float> restored;
+        TextLoader restored_loader;
+        ModelCheckpoint::load(path, restored, restored_loader, mapped);
+        const std::string mode = mapped ? " (mmap)" : " (copia)";
+
+        check(restored_loader.get_feature_size() == loader.get_feature_size(), name + mode + ": ancho de entrada");
+        check(restored_loader.get_vocabulary() == loader.get_vocabulary(), name + mode + ": vocabulario");
+        check(same_scores(restored.predict(X), expected), name + mode + ": mismas predicciones");
+
+        const std::string message = "Free entry! Call now to claim your prize";
+        auto a = loader.vectorize_sparse(message), b = restored_loader.vectorize_sparse(message);
+        check(a.indices == b.indices && a.values == b.values, name + mode + ": misma vectorizacion");
+
+        // Volver a guardar lo cargado reproduce el mismo archivo
+        ModelCheckpoint::save(path + ".copy", restored, restored_loader);
+        check(read_file(path + ".copy") == read_file(path), name + mode + ": guardado estable");
+        std::remove((path + ".copy").c_str());
+    }
+
+    // El modelo cargado como copia se puede seguir entrenando
+    NeuralNetwork<float> trainable;
+    TextLoader trainable_loader;
+    ModelCheckpoint::load(path, trainable, trainable_loader, false);
+    bool trained = true;
+    try { trainable.train<BCELoss>(X, Y, 1, 64, 0.5f); } catch (...) { trained = false; }
+    check(trained, name + ": copia entrenable");
+
+    // Archivo truncado: debe rechazarse sin tocar el modelo
+    const auto bytes = read_file(path);
+    std::ofstream(path, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+    bool rejected = false;
+    try { ModelCheckpoint::load(path, trainable, trainable_loader); } catch (const std::runtime_error&) { rejected = true; }
+    check(rejected && trainable.layer_count() == 4, name + ": archivo truncado rechazado");
+    std::remove(path.c_str());
+}
+
+// Una red con activaciones fusionadas en sus Dense da las mismas salidas y
+// se guarda igual que sin fusionar (Dense + activación por separado)
+void fused_round_trip(TextLoader& loader) {
+    loader.load_data();
+    auto X = DatasetUtils::vector_to_csr(loader.get_dataset());
+    auto build = [&] {
+        std::mt19937 rng(11);
+        std::normal_distribution<float> dist(0.0f, 0.1f);
+        auto init = [&](Tensor<float, 2>& t) { for (auto it = t.begin(); it != t.end(); ++it) *it = dist(rng); };
+        NeuralNetwork<float> model;
+        model.add_layer(std::make_unique<Dense<float>>(loader.get_feature_size(), 16, init, init));
+        model.add_layer(std::make_unique<LeakyReLU<float>>(0.2f));
+        model.add_layer(std::make_unique<Dense<float>>(16, 8, init, init));
+        model.add_layer(std::make_unique<GELU<float>>());
+        model.add_layer(std::make_unique<Dense<float>>(8, 4, init, init));
+        model.add_layer(std::make_unique<Tanh<float>>());
+        model.add_layer(std::make_unique<Softmax<float>>());
+        return model;
+    };
+    auto plain = build();
+    auto fused = build();
+    fused.fuse_layers();
+    check(fused.layer_count() == 4, "fusion: Dense absorbe la activacion siguiente");
+    check(same_scores(fused.predict(X), plain.predict(X)), "fusion: mismas predicciones");
+
+    const std::string path = "checkpoint_fused.bin";
+    ModelCheckpoint::save(path, plain, loader);
+    const auto expected = read_file(path);
+    ModelCheckpoint::save(path, fused, loader);
+    check(read_file(path) == expected, "fusion: mismo archivo que sin fusionar");
+
+    NeuralNetwork<float> restored;
+    TextLoader restored_loader;
+    ModelCheckpoint::load(path, restored, restored_loader, false);
+    check(restored.layer_count() == 7 && same_scores(restored.predict(X), plain.predict(X)),
+          "fusion: LeakyReLU, GELU, Tanh y Softmax se recuperan");
+    std::remove(path.c_str());
+}
+
+int main() {
+    TextLoader vocabulary_loader("training_words_eng.csv");
+    round_trip(vocabulary_loader, "vocabulario");
+
+    TextLoader hashing_loader("training_words_eng.csv", HashingConfig{12, 2});
+    round_trip(hashing_loader, "hashing");
+
+    TextLoader fused_loader("training_words_eng.csv");
+    fused_round_trip(fused_loader);
+
+    std::cout << (failures ? "Fallaron " + std::to_string(failures) + " pruebas" : "Todas las pruebas pasaron") << "\n";
+    return failures ? 1 : 0;
+}
@@ -4,23 +4,50 @@
 
 #include "DatasetUtils.h"
 #include <algorithm>
-#include <chrono>
+#include <numeric>
 #include <random>
 
 using namespace utec::algebra;
 using namespace utec::data;
 
+namespace {
+
+    std::vector<size_t> all_indices(size_t n) {
+        std::vector<size_t> indices(n);
+        std::iota(indices.begin(), indices.end(), size_t{0});
+        return indices;
+    }
+
+}
+
 Tensor<float, 2> DatasetUtils::vector_to_tensor(const std::vector<TextExample> &dataset) {
-    if (dataset.empty()) return Tensor<float, 2>(0, 0);
+    return vector_to_tensor(dataset, all_indices(dataset.size()));
+}
+
+
+CsrMatrix<float> DatasetUtils::vector_to_csr(const std::vector<TextExample> &dataset) {
+    return vector_to_csr(dataset, all_indices(dataset.size()));
+}
 
-    size_t num_samples = dataset.size();
-    size_t num_features = dataset[0].vectorized_text.size();
+
+utec::algebra::Tensor<float, 2> DatasetUtils::labels_to_tensor(const std::vector<TextExample> &dataset) {
+    return labels_to_tensor(dataset, all_indices(dataset.size()));
+}
+
+
+Tensor<float, 2> DatasetUtils::vector_to_tensor(const std::vector<TextExample> &dataset,
+                                                const std::vector<size_t> &indices) {
+    if (dataset.empty() || indices.empty()) return Tensor<float, 2>(0, 0);
+
+    size_t num_samples = indices.size();
+    size_t num_features = dataset[0].vectorized_text.dimension;
 
     Tensor<float, 2> tensor(num_samples,num_features);
 
     for (size_t i = 0; i < num_samples; ++i) {
-        for (size_t j = 0; j < num_features; ++j) {
-            tensor(i, j) = dataset[i].vectorized_text[j];
+        const auto& row = dataset[indices[i]].vectorized_text;
+        for (size_t p = 0; p < row.indices.size(); ++p) {
+            tensor(i, row.indices[p]) = row.values[p];
         }
     }
 
@@ -28,34 +55,93 @@ Tensor<float, 2> DatasetUtils::vector_to_tensor(const std::vector<TextExample> &
 }
 
 
-utec::algebra::Tensor<float, 2> DatasetUtils::labels_to_tensor(const std::vector<TextExample> &dataset) {
-    if (dataset.empty()) return Tensor<float, 2>(0, 0);
+CsrMatrix<float> DatasetUtils::vector_to_csr(const std::vector<TextExample> &dataset,
+                                             const std::vector<size_t> &indices) {
+    if (dataset.empty()) return CsrMatrix<float>(0);
+
+    size_t nnz = 0;
+    for (auto i : indices) nnz += dataset[i].vectorized_text.indices.size();
+
+    CsrMatrix<float> matrix(dataset[0].vectorized_text.dimension);
+    matrix.reserve(indices.size(), nnz);
 
-    size_t num_samples = dataset.size();
+    for (auto i : indices) {
+        const auto& row = dataset[i].vectorized_text;
+        matrix.push_row(row.indices.data(), row.values.data(), row.indices.size());
+    }
+
+    return matrix;
+}
+
+
+utec::algebra::Tensor<float, 2> DatasetUtils::labels_to_tensor(const std::vector<TextExample> &dataset,
+                                                               const std::vector<size_t> &indices) {
+    if (dataset.empty() || indices.empty()) return Tensor<float, 2>(0, 0);
+
+    size_t num_samples = indices.size();
 
     Tensor<float, 2> labels(num_samples, 1);
 
     for (size_t i = 0; i < num_samples; ++i) {
-        labels(i, 0) = static_cast<float>(dataset[i].label);
+        labels(i, 0) = static_cast<float>(dataset[indices[i]].label);
     }
 
     return labels;
 }
 
 
+void DatasetUtils::shuffle_indices(std::vector<size_t> &indices, std::uint64_t seed, size_t epoch) {
+    std::seed_seq seq{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32),
+                      static_cast<std::uint32_t>(epoch)};
+    std::mt19937_64 rng(seq);
 
-void DatasetUtils::split_dataset(const std::vector<TextExample> &dataset, std::vector<TextExample> &train_set, std::vector<TextExample> &test_set, float train_ratio) {
-    train_set.clear(); test_set.clear();
+    // Fisher-Yates propio: std::shuffle no da el mismo orden en todas las librerías estándar
+    for (size_t i = indices.size(); i > 1; --i) {
+        std::swap(indices[i - 1], indices[rng() % i]);
+    }
+}
 
-    std::vector<TextExample> shuffled = dataset;
 
-    std::mt19937 rng(std::chrono::steady_clock::now().time_since_epoch().count());
-    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+DatasetSplit DatasetUtils::split_indices(const std::vector<TextExample> &dataset, float train_ratio,
+                                         std::uint64_t seed, bool stratified) {
+    DatasetSplit split;
 
-    size_t train_size = static_cast<size_t>(train_ratio * shuffled.size());
+    if (!stratified) {
+        auto shuffled = all_indices(dataset.size());
+        shuffle_indices(shuffled, seed);
+        size_t train_size = static_cast<size_t>(train_ratio * shuffled.size());
+        split.train.assign(shuffled.begin(), shuffled.begin() + train_size);
+        split.test.assign(shuffled.begin() + train_size, shuffled.end());
+        return split;
+    }
+
+    // Cada clase se baraja y se corta por separado
+    std::vector<size_t> by_label[2];
+    for (size_t i = 0; i < dataset.size(); ++i) by_label[dataset[i].label ? 1 : 0].push_back(i);
 
-    train_set.insert(train_set.end(), shuffled.begin(), shuffled.begin() + train_size);
-    test_set.insert(test_set.end(), shuffled.begin() + train_size, shuffled.end());
+    for (size_t label = 0; label < 2; ++label) {
+        auto& group = by_label[label];
+        shuffle_indices(group, seed, label);
+        size_t train_size = static_cast<size_t>(train_ratio * group.size());
+        split.train.insert(split.train.end(), group.begin(), group.begin() + train_size);
+        split.test.insert(split.test.end(), group.begin() + train_size, group.end());
+    }
+
+    // Mezclar las clases entre sí
+    shuffle_indices(split.train, seed, 2);
+    shuffle_indices(split.test, seed, 3);
+    return split;
 }
 
 
+void DatasetUtils::split_dataset(const std::vector<TextExample> &dataset, std::vector<TextExample> &train_set, std::vector<TextExample> &test_set, float train_ratio, std::uint64_t seed) {
+    train_set.clear(); test_set.clear();
+
+    auto split = split_indices(dataset, train_ratio, seed);
+
+    train_set.reserve(split.train.size());
+    test_set.reserve(split.test.size());
+    for (auto i : split.train) train_set.push_back(dataset[i]);
+    for (auto i : split.test) test_set.push_back(dataset[i]);
+}
+
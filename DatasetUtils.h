@@ -6,20 +6,52 @@
 #define DATASETUTILS_H
 
 #include "tensor.h"
+#include "tensor_sparse.h"
 #include "TextLoader.h"
+#include <cstdint>
 
 namespace utec::data {
 
+    // División del dataset como índices (no se copian los ejemplos)
+    struct DatasetSplit {
+        std::vector<size_t> train;
+        std::vector<size_t> test;
+    };
+
     class DatasetUtils {
     public:
+        static constexpr std::uint64_t default_seed = 42;
+
         static utec::algebra::Tensor<float, 2> vector_to_tensor(const std::vector<TextExample>& dataset);
+        static utec::algebra::CsrMatrix<float> vector_to_csr(const std::vector<TextExample>& dataset);
         static utec::algebra::Tensor<float, 2> labels_to_tensor(const std::vector<TextExample>& dataset);
 
-        // split dataset: dividir los datos entre entrenamiento y prueba
+        // Igual que las anteriores pero solo con las filas indicadas, en ese orden
+        static utec::algebra::Tensor<float, 2> vector_to_tensor(const std::vector<TextExample>& dataset,
+                                                                const std::vector<size_t>& indices);
+        static utec::algebra::CsrMatrix<float> vector_to_csr(const std::vector<TextExample>& dataset,
+                                                             const std::vector<size_t>& indices);
+        static utec::algebra::Tensor<float, 2> labels_to_tensor(const std::vector<TextExample>& dataset,
+                                                                const std::vector<size_t>& indices);
+
+        // split por índices: reproducible con la misma semilla. Estratificado
+        // mantiene la proporción spam / no spam en entrenamiento y prueba
+        static DatasetSplit split_indices(const std::vector<TextExample>& dataset,
+                                          float train_ratio = 0.8,
+                                          std::uint64_t seed = default_seed,
+                                          bool stratified = false);
+
+        // Baraja indices en su lugar (Fisher-Yates). La permutación aplicada
+        // depende solo de (seed, epoch) y del tamaño: para un orden que no
+        // dependa de las épocas anteriores, reiniciar indices antes de llamar
+        static void shuffle_indices(std::vector<size_t>& indices, std::uint64_t seed, size_t epoch = 0);
+
+        // split dataset: dividir los datos entre entrenamiento y prueba (copia los ejemplos)
         static void split_dataset(const std::vector<TextExample>& dataset,
                                   std::vector<TextExample>& train_set,
                                   std::vector<TextExample>& test_set,
-                                  float train_ratio = 0.8);
+                                  float train_ratio = 0.8,
+                                  std::uint64_t seed = default_seed);
     };
 
 }
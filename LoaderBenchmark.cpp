@@ -0,0 +1,139 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include "TextLoader.h"
+
+using namespace utec::data;
+
+// Replica el cuerpo del CSV (sin cabecera) hasta alcanzar target_bytes
+std::string make_replicated_csv(const std::string& source, size_t target_bytes) {
+    std::ifstream in(source);
+    std::string header, line, body;
+    std::getline(in, header);
+    while (std::getline(in, line)) body += line + "\n";
+
+    const std::string path = "loader_benchmark_tmp.csv";
+    std::ofstream out(path, std::ios::binary);
+    out << header << "\n";
+    size_t written = header.size() + 1;
+    while (written < target_bytes) {
+        out << body;
+        written += body.size();
+    }
+    return path;
+}
+
+// Cargador anterior (dos pasadas con getline + stringstream por línea y por
+// palabra) como referencia. Solo se construye el vocabulario y se cuentan las
+// palabras: la versión original además materializaba un vector denso por mensaje
+size_t legacy_load(const std::string& filename) {
+    std::unordered_map<std::string, int> vocabulary;
+    auto tokenize = [](const std::string& text) {
+        std::stringstream ss(text);
+        std::string word;
+        std::vector<std::string> tokens;
+        while (ss >> word) {
+            word.erase(std::remove_if(word.begin(), word.end(), ispunct), word.end());
+            std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+            tokens.push_back(word);
+        }
+        return tokens;
+    };
+
+    std::ifstream file(filename);
+    std::string line;
+    std::getline(file, line);
+    std::unordered_set<std::string> unique_words;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string label_text, message;
+        std::getline(ss, label_text, ',');
+        std::getline(ss, message);
+        auto words = tokenize(message);
+        unique_words.insert(words.begin(), words.end());
+    }
+    int index = 0;
+    for (const auto& word : unique_words) vocabulary[word] = index++;
+
+    file.clear();
+    file.seekg(0);
+    std::getline(file, line);
+    size_t hits = 0;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string label_text, message;
+        std::getline(ss, label_text, ',');
+        std::getline(ss, message);
+        for (const auto& word : tokenize(message))
+            if (vocabulary.find(word) != vocabulary.end()) ++hits;
+    }
+    return hits;
+}
+
+template<typename F>
+double seconds(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Mismo vocabulario (mismos ids) y mismos vectores
+bool same_result(const TextLoader& a, const TextLoader& b) {
+    if (!(a.get_vocabulary() == b.get_vocabulary())) return false;
+    const auto& x = a.get_dataset();
+    const auto& y = b.get_dataset();
+    if (x.size() != y.size()) return false;
+    for (size_t i = 0; i < x.size(); ++i) {
+        if (x[i].label != y[i].label ||
+            x[i].vectorized_text.indices != y[i].vectorized_text.indices ||
+            x[i].vectorized_text.values != y[i].vectorized_text.values) return false;
+    }
+    return true;
+}
+
+// Uso: LoaderBenchmark [MB] [hilos max] (por defecto 1024 MB y todos los núcleos)
+int main(int argc, char* argv[]) {
+    const size_t megabytes = argc > 1 ? std::stoul(argv[1]) : 1024;
+    const size_t max_threads = argc > 2 ? std::stoul(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    const std::string path = make_replicated_csv("training_words_eng.csv", megabytes << 20);
+
+    std::ifstream probe(path, std::ios::binary | std::ios::ate);
+    const double mb = static_cast<double>(probe.tellg()) / (1 << 20);
+    probe.close();
+
+    TextLoader loader(path);
+    loader.set_num_threads(1);
+    double t_new = seconds([&] { loader.load_data(); });
+    size_t hits = 0;
+    double t_old = seconds([&] { hits = legacy_load(path); });
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Archivo: " << mb << " MB, " << loader.get_dataset().size() << " mensajes, vocabulario "
+              << loader.get_vocabulary_size() << "\n";
+    std::cout << "load_data (mmap, una pasada): " << t_new << " s  (" << mb / t_new << " MB/s)\n";
+    std::cout << "referencia (dos pasadas)    : " << t_old << " s  (" << mb / t_old << " MB/s)\n";
+
+    // Escalado con hilos; el resultado debe ser idéntico al de un hilo
+    bool identical = true;
+    for (size_t threads = 2; threads <= max_threads; threads *= 2) {
+        TextLoader parallel(path);
+        parallel.set_num_threads(threads);
+        const double t = seconds([&] { parallel.load_data(); });
+        const bool same = same_result(loader, parallel);
+        identical = identical && same;
+        std::cout << "load_data, " << std::setw(2) << threads << " hilos     : " << t << " s  ("
+                  << mb / t << " MB/s, x" << t_new / t << ")  mismos ids " << (same ? "si" : "NO") << "\n";
+    }
+
+    std::remove(path.c_str());
+    return hits == 0 || !identical;
+}
@@ -0,0 +1,83 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#include "MappedFile.h"
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define UTEC_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace utec::data;
+
+MappedFile::MappedFile(const std::string& filename) {
+#ifdef UTEC_HAS_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return;
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            size_ = 0;
+            return;
+        }
+        ::madvise(p, size_, MADV_SEQUENTIAL); // se recorre una sola vez de inicio a fin
+        data_ = static_cast<const char*>(p);
+        mapped_ = true;
+    }
+    ::close(fd); // el mapeo sigue vigente sin el descriptor
+    open_ = true;
+#else
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return;
+    buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    open_ = true;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this == &other) return *this;
+    release();
+    open_ = std::exchange(other.open_, false);
+    mapped_ = std::exchange(other.mapped_, false);
+    size_ = std::exchange(other.size_, 0);
+    buffer_ = std::move(other.buffer_);
+    data_ = mapped_ ? std::exchange(other.data_, nullptr) : buffer_.data();
+    other.data_ = nullptr;
+    return *this;
+}
+
+void MappedFile::release() {
+#ifdef UTEC_HAS_MMAP
+    if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    open_ = mapped_ = false;
+    buffer_.clear();
+}
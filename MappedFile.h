@@ -0,0 +1,43 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <string_view>
+
+namespace utec::data {
+
+    // Archivo de solo lectura proyectado en memoria (mmap). En plataformas sin
+    // mmap se lee completo a un buffer, la interfaz es la misma
+    class MappedFile {
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        bool open_ = false;
+        bool mapped_ = false;
+        std::string buffer_;
+
+        void release();
+
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::string& filename);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        bool is_open() const { return open_; }
+        std::string_view view() const { return {data_, size_}; }
+        const char* data() const { return data_; }
+        size_t size() const { return size_; }
+    };
+
+}
+
+#endif //MAPPEDFILE_H
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <bit>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "tensor_math.h"
+
+using namespace utec::algebra;
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    std::cout << (condition ? "[OK]    " : "[FALLA] ") << what << "\n";
+    if (!condition) ++failures;
+}
+
+// Error en ULP de y respecto al valor exacto ref (calculado en double)
+double ulp_error(float y, double ref) {
+    if (std::isnan(ref)) return std::isnan(y) ? 0.0 : std::numeric_limits<double>::infinity();
+    if (std::isnan(y)) return std::numeric_limits<double>::infinity();
+    if (std::abs(ref) > std::numeric_limits<float>::max()) {
+        // El resultado correcto redondeado es ±inf o ±FLT_MAX
+        const float rounded = static_cast<float>(ref);
+        return y == rounded || std::abs(y) == std::numeric_limits<float>::max() ? 0.0
+                                                                                : std::numeric_limits<double>::infinity();
+    }
+    if (std::isinf(y)) return std::numeric_limits<double>::infinity();
+    int e = 0;
+    std::frexp(ref, &e);
+    const double ulp = std::max(std::ldexp(1.0, e - 24), std::ldexp(1.0, -149));
+    return std::abs(static_cast<double>(y) - ref) / ulp;
+}
+
+struct Function {
+    const char* name;
+    vmath::UnaryKernel vmath::Kernels::* kernel;
+    double (*reference)(double);
+    double max_ulp; // cota documentada en tensor_math.h
+};
+
+// Recorre todos los floats con paso fijo en su patrón de bits (ambos signos,
+// denormales, infinitos y NaN incluidos) más valores densos en el rango usual
+double max_ulp(const vmath::Kernels& k, const Function& f) {
+    std::vector<float> x, y;
+    for (std::uint64_t bits = 0; bits <= 0xffffffffu; bits += 509)
+        x.push_back(std::bit_cast<float>(static_cast<std::uint32_t>(bits)));
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-20.0f, 20.0f);
+    for (int i = 0; i < 1000000; ++i) x.push_back(dist(rng));
+    y.resize(x.size());
+
+    // Bloques de largo impar para pasar también por las colas enmascaradas
+    constexpr std::size_t block = 4099;
+    for (std::size_t i = 0; i < x.size(); i += block)
+        (k.*f.kernel)(x.data() + i, y.data() + i, std::min(block, x.size() - i));
+
+    double worst = 0;
+    for (std::size_t i = 0; i < x.size(); ++i)
+        worst = std::max(worst, ulp_error(y[i], f.reference(x[i])));
+    return worst;
+}
+
+// Casos especiales con resultado exacto
+void special_values(const vmath::Kernels& k) {
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    auto run = [&](vmath::UnaryKernel fn, float v) { float r; fn(&v, &r, 1); return r; };
+    const std::string p = std::string(k.name) + ": ";
+
+    check(run(k.exp, 0.0f) == 1.0f && run(k.exp, inf) == inf && run(k.exp, -inf) == 0.0f
+          && run(k.exp, 100.0f) == inf && run(k.exp, -200.0f) == 0.0f && std::isnan(run(k.exp, nan)),
+          p + "exp en 0, ±inf, desborde y NaN");
+    check(run(k.log, 1.0f) == 0.0f && run(k.log, inf) == inf && run(k.log, 0.0f) == -inf
+          && run(k.log, -0.0f) == -inf && std::isnan(run(k.log, -1.0f)) && std::isnan(run(k.log, nan)),
+          p + "log en 1, inf, ±0, negativos y NaN");
+    check(run(k.sigmoid, 0.0f) == 0.5f && run(k.sigmoid, inf) == 1.0f && run(k.sigmoid, -inf) == 0.0f
+          && std::isnan(run(k.sigmoid, nan)), p + "sigmoid en 0, ±inf y NaN");
+    check(run(k.tanh, 0.0f) == 0.0f && std::signbit(run(k.tanh, -0.0f)) && run(k.tanh, inf) == 1.0f
+          && run(k.tanh, -inf) == -1.0f && std::isnan(run(k.tanh, nan)), p + "tanh en ±0, ±inf y NaN");
+}
+
+// Misma salida que elemento por elemento para cualquier largo (colas) y en el mismo arreglo
+void lengths_and_in_place(const vmath::Kernels& k) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    bool same = true;
+    for (std::size_t n = 1; n <= 40; ++n) {
+        std::vector<float> x(n), y(n), one(n);
+        for (auto& v : x) v = dist(rng);
+        k.tanh(x.data(), y.data(), n);
+        for (std::size_t i = 0; i < n; ++i) k.tanh(x.data() + i, one.data() + i, 1);
+        k.tanh(x.data(), x.data(), n);
+        same = same && y == one && x == y;
+    }
+    check(same, std::string(k.name) + ": largos 1..40 y en el mismo arreglo");
+}
+
+int main() {
+    const Function functions[] = {
+        {"exp", &vmath::Kernels::exp, [](double x) { return std::exp(x); }, 1.5},
+        {"log", &vmath::Kernels::log, [](double x) { return std::log(x); }, 1},
+        {"sigmoid", &vmath::Kernels::sigmoid, [](double x) { return 1 / (1 + std::exp(-x)); }, 2.5},
+        {"tanh", &vmath::Kernels::tanh, [](double x) { return std::tanh(x); }, 1.5},
+    };
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Ruta activa: " << vmath::active_kernels().name << "\n";
+    for (const auto& k : vmath::supported_kernels()) {
+        for (const auto& f : functions) {
+            const double ulp = max_ulp(k, f);
+            check(ulp <= f.max_ulp, std::string(k.name) + ": " + f.name + " error max " + std::to_string(ulp)
+                                    + " ULP (cota " + std::to_string(f.max_ulp) + ")");
+        }
+        special_values(k);
+        lengths_and_in_place(k);
+    }
+
+    std::cout << (failures ? "Fallaron " + std::to_string(failures) + " pruebas" : "Todas las pruebas pasaron") << "\n";
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,310 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#include "ModelCheckpoint.h"
+#include "MappedFile.h"
+#include "nn_dense.h"
+#include "nn_activation.h"
+#include <bit>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+using namespace utec::data;
+using namespace utec::neural_network;
+
+namespace {
+
+    constexpr char magic[8] = {'U', 'T', 'E', 'C', 'N', 'N', 'C', 'K'};
+    constexpr std::uint32_t endian_tag = 0x01020304;
+    constexpr std::uint64_t section_alignment = 64;
+
+    enum class LayerKind : std::uint32_t {
+        Dense = 1, ReLU = 2, Sigmoid = 3, LeakyReLU = 4, Tanh = 5, GELU = 6, Softmax = 7
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t endian;
+        std::uint32_t scalar_size;
+        std::uint32_t layer_count;
+        std::uint32_t hashing;
+        std::uint32_t hashing_bits;
+        std::uint32_t hashing_ngram;
+        std::uint32_t hashing_signed;
+        std::uint64_t vocab_count;
+        std::uint64_t vocab_offsets;  // vocab_count + 1 offsets (uint64) dentro de vocab_chars
+        std::uint64_t vocab_chars;
+        std::uint64_t file_size;
+    };
+
+    // Solo Dense usa in/out y los offsets; las activaciones los dejan en 0.
+    // param guarda los bits (float) de la pendiente de LeakyReLU
+    struct LayerRecord {
+        std::uint32_t kind;
+        std::uint32_t param;
+        std::uint64_t in_features;
+        std::uint64_t out_features;
+        std::uint64_t weights;
+        std::uint64_t bias;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) == 72);
+    static_assert(std::is_trivially_copyable_v<LayerRecord> && sizeof(LayerRecord) == 40);
+
+    std::uint64_t align_up(std::uint64_t n) {
+        return (n + section_alignment - 1) / section_alignment * section_alignment;
+    }
+
+    // Buffer del archivo completo: cada sección se agrega alineada y devuelve su offset
+    class Writer {
+        std::vector<char> bytes_;
+    public:
+        std::uint64_t append(const void* data, std::uint64_t size) {
+            const std::uint64_t offset = align_up(bytes_.size());
+            bytes_.resize(offset + size);
+            if (size) std::memcpy(bytes_.data() + offset, data, size);
+            return offset;
+        }
+        void write_at(std::uint64_t offset, const void* data, std::uint64_t size) {
+            std::memcpy(bytes_.data() + offset, data, size);
+        }
+        const std::vector<char>& bytes() const { return bytes_; }
+    };
+
+    void write_atomically(const std::string& path, const std::vector<char>& bytes) {
+        const std::string tmp = path + ".tmp";
+        std::FILE* file = std::fopen(tmp.c_str(), "wb");
+        if (!file) throw std::runtime_error("Cannot create checkpoint file: " + tmp);
+
+        bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        ok = std::fflush(file) == 0 && ok;
+#if defined(__unix__) || defined(__APPLE__)
+        ok = ::fsync(::fileno(file)) == 0 && ok; // los datos en disco antes del rename
+#endif
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            throw std::runtime_error("Cannot write checkpoint file: " + path);
+        }
+    }
+
+    // Valida que [offset, offset + size) esté dentro del archivo
+    const char* section(const MappedFile& file, std::uint64_t offset, std::uint64_t size) {
+        if (offset > file.size() || size > file.size() - offset)
+            throw std::runtime_error("Corrupt checkpoint: section out of bounds");
+        return file.data() + offset;
+    }
+
+    const float* float_section(const MappedFile& file, std::uint64_t offset, std::uint64_t count) {
+        if (count > file.size() / sizeof(float)) throw std::runtime_error("Corrupt checkpoint: section too large");
+        const char* p = section(file, offset, count * sizeof(float));
+        if (reinterpret_cast<std::uintptr_t>(p) % alignof(float) != 0)
+            throw std::runtime_error("Corrupt checkpoint: misaligned weights");
+        return reinterpret_cast<const float*>(p);
+    }
+
+}
+
+void ModelCheckpoint::save(const std::string& path, const NeuralNetwork<float>& model, const TextLoader& loader) {
+    Writer out;
+    // Una Dense con activación fusionada se guarda como Dense + activación, así
+    // el archivo describe siempre la red sin fusionar
+    size_t record_count = model.layer_count();
+    for (size_t i = 0; i < model.layer_count(); ++i)
+        if (auto* dense = dynamic_cast<const Dense<float>*>(&model.layer(i)))
+            record_count += dense->activation().kind != ActivationKind::Identity;
+
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = format_version;
+    header.endian = endian_tag;
+    header.scalar_size = sizeof(float);
+    header.layer_count = static_cast<std::uint32_t>(record_count);
+    header.hashing = loader.is_hashing();
+    header.hashing_bits = loader.get_hashing_config().bits;
+    header.hashing_ngram = loader.get_hashing_config().max_ngram;
+    header.hashing_signed = loader.get_hashing_config().signed_hash;
+    out.append(&header, sizeof(header));
+
+    // La tabla se reserva ahora y se completa cuando se conocen los offsets
+    std::vector<LayerRecord> table(record_count);
+    const std::uint64_t table_offset = out.append(table.data(), table.size() * sizeof(LayerRecord));
+
+    // Los parámetros entrenables ya están contiguos en la arena del modelo: se
+    // escriben de una vez y cada capa apunta a su tramo. Cada tramo empieza en
+    // una línea de caché, así que los pesos quedan alineados también en el archivo.
+    // Una red sin finalizar no tiene arena: cada capa se escribe por separado
+    const auto arena = model.parameter_values();
+    const std::uint64_t arena_offset = out.append(arena.data(), arena.size_bytes());
+    auto place = [&](std::span<const float> s) {
+        if (!arena.empty() && s.data() >= arena.data() && s.data() + s.size() <= arena.data() + arena.size())
+            return arena_offset + static_cast<std::uint64_t>(s.data() - arena.data()) * sizeof(float);
+        return out.append(s.data(), s.size_bytes()); // MappedDense o red sin finalizar: pesos fuera de la arena
+    };
+
+    auto write_dense = [&](LayerRecord& record, size_t in_f, size_t out_f,
+                           std::span<const float> w, std::span<const float> b) {
+        record.kind = static_cast<std::uint32_t>(LayerKind::Dense);
+        record.in_features = in_f;
+        record.out_features = out_f;
+        record.weights = place(w);
+        record.bias = place(b);
+    };
+
+    auto write_activation = [](LayerRecord& record, const Activation<float>& act) {
+        switch (act.kind) {
+            case ActivationKind::ReLU: record.kind = static_cast<std::uint32_t>(LayerKind::ReLU); break;
+            case ActivationKind::Sigmoid: record.kind = static_cast<std::uint32_t>(LayerKind::Sigmoid); break;
+            case ActivationKind::Tanh: record.kind = static_cast<std::uint32_t>(LayerKind::Tanh); break;
+            case ActivationKind::GELU: record.kind = static_cast<std::uint32_t>(LayerKind::GELU); break;
+            case ActivationKind::LeakyReLU:
+                record.kind = static_cast<std::uint32_t>(LayerKind::LeakyReLU);
+                record.param = std::bit_cast<std::uint32_t>(act.slope);
+                break;
+            default: throw std::invalid_argument("Checkpoint does not support this layer type");
+        }
+    };
+
+    size_t next = 0;
+    for (size_t i = 0; i < model.layer_count(); ++i) {
+        const auto& layer = model.layer(i);
+        auto& record = table[next++];
+        if (auto* dense = dynamic_cast<const Dense<float>*>(&layer)) {
+            write_dense(record, dense->in_features(), dense->out_features(), dense->weights(), dense->bias());
+            if (dense->activation().kind != ActivationKind::Identity)
+                write_activation(table[next++], dense->activation());
+        } else if (auto* mapped = dynamic_cast<const MappedDense<float>*>(&layer)) {
+            write_dense(record, mapped->in_features(), mapped->out_features(), mapped->weights(), mapped->bias());
+        } else if (auto* act = dynamic_cast<const ElementwiseActivation<float>*>(&layer)) {
+            write_activation(record, act->activation());
+        } else if (dynamic_cast<const Softmax<float>*>(&layer)) {
+            record.kind = static_cast<std::uint32_t>(LayerKind::Softmax);
+        } else {
+            throw std::invalid_argument("Checkpoint does not support this layer type");
+        }
+    }
+    out.write_at(table_offset, table.data(), table.size() * sizeof(LayerRecord));
+
+    // Vocabulario: offsets de cada palabra dentro de un solo bloque de caracteres
+    const auto& words = loader.get_vocabulary();
+    std::vector<std::uint64_t> offsets{0};
+    offsets.reserve(words.size() + 1);
+    std::string chars;
+    for (std::uint32_t i = 0; i < words.size(); ++i) {
+        chars += words[i];
+        offsets.push_back(chars.size());
+    }
+    header.vocab_count = words.size();
+    header.vocab_offsets = out.append(offsets.data(), offsets.size() * sizeof(std::uint64_t));
+    header.vocab_chars = out.append(chars.data(), chars.size());
+    header.file_size = out.bytes().size();
+    out.write_at(0, &header, sizeof(header));
+
+    write_atomically(path, out.bytes());
+}
+
+void ModelCheckpoint::load(const std::string& path, NeuralNetwork<float>& model, TextLoader& loader, bool mapped) {
+    auto file = std::make_shared<MappedFile>(path);
+    if (!file->is_open()) throw std::runtime_error("Cannot open checkpoint file: " + path);
+
+    Header header;
+    std::memcpy(&header, section(*file, 0, sizeof(Header)), sizeof(Header));
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+        throw std::runtime_error("Not a model checkpoint: " + path);
+    if (header.version != format_version)
+        throw std::runtime_error("Unsupported checkpoint version " + std::to_string(header.version));
+    if (header.endian != endian_tag || header.scalar_size != sizeof(float))
+        throw std::runtime_error("Checkpoint was written on an incompatible platform");
+    if (header.file_size != file->size())
+        throw std::runtime_error("Corrupt checkpoint: truncated file");
+
+    if (header.layer_count > file->size() / sizeof(LayerRecord))
+        throw std::runtime_error("Corrupt checkpoint: layer table too large");
+    std::vector<LayerRecord> table(header.layer_count);
+    std::memcpy(table.data(), section(*file, align_up(sizeof(Header)), table.size() * sizeof(LayerRecord)),
+                table.size() * sizeof(LayerRecord));
+
+    // Vectorizador: se aplica a loader recién al final, si todo el archivo es válido
+    const HashingConfig hashing{header.hashing_bits, header.hashing_ngram, header.hashing_signed != 0};
+    std::vector<std::string_view> words; // apuntan al archivo; Vocabulary las copia
+    if (header.hashing) {
+        if (hashing.bits == 0 || hashing.bits > 31 || hashing.max_ngram == 0)
+            throw std::runtime_error("Corrupt checkpoint: bad hashing configuration");
+    } else {
+        if (header.vocab_count >= file->size() / sizeof(std::uint64_t))
+            throw std::runtime_error("Corrupt checkpoint: vocabulary too large");
+        std::vector<std::uint64_t> offsets(header.vocab_count + 1);
+        std::memcpy(offsets.data(), section(*file, header.vocab_offsets, offsets.size() * sizeof(std::uint64_t)),
+                    offsets.size() * sizeof(std::uint64_t));
+        const char* chars = section(*file, header.vocab_chars, offsets.back());
+        words.reserve(header.vocab_count);
+        for (size_t i = 0; i < header.vocab_count; ++i) {
+            if (offsets[i] > offsets[i + 1] || offsets[i + 1] > offsets.back())
+                throw std::runtime_error("Corrupt checkpoint: bad vocabulary offsets");
+            words.emplace_back(chars + offsets[i], offsets[i + 1] - offsets[i]);
+        }
+    }
+
+    NeuralNetwork<float> restored;
+    // Copia (mapped = false): las capas se crean vacías y los pesos se copian
+    // al final directamente a la arena del modelo
+    struct PendingCopy { const float* w; const float* b; size_t layer; };
+    std::vector<PendingCopy> copies;
+    size_t expected_in = header.hashing ? size_t{1} << hashing.bits : words.size();
+    const std::shared_ptr<const void> owner = file;
+    for (const auto& record : table) {
+        switch (static_cast<LayerKind>(record.kind)) {
+            case LayerKind::Dense: {
+                if (record.in_features != expected_in)
+                    throw std::runtime_error("Checkpoint layer sizes do not match its vectorizer");
+                const size_t in_f = record.in_features, out_f = record.out_features;
+                if (out_f != 0 && in_f > file->size() / out_f)
+                    throw std::runtime_error("Corrupt checkpoint: layer too large");
+                const float* w = float_section(*file, record.weights, in_f * out_f);
+                const float* b = float_section(*file, record.bias, out_f);
+                if (mapped) {
+                    restored.add_layer(std::make_unique<MappedDense<float>>(w, b, in_f, out_f, owner));
+                } else {
+                    copies.push_back({w, b, restored.layer_count()});
+                    restored.add_layer(std::make_unique<Dense<float>>(in_f, out_f,
+                        [](utec::algebra::Tensor<float, 2>&) {}, [](utec::algebra::Tensor<float, 2>&) {}));
+                }
+                expected_in = out_f;
+                break;
+            }
+            case LayerKind::ReLU: restored.add_layer(std::make_unique<ReLU<float>>()); break;
+            case LayerKind::Sigmoid: restored.add_layer(std::make_unique<Sigmoid<float>>()); break;
+            case LayerKind::Tanh: restored.add_layer(std::make_unique<Tanh<float>>()); break;
+            case LayerKind::GELU: restored.add_layer(std::make_unique<GELU<float>>()); break;
+            case LayerKind::Softmax: restored.add_layer(std::make_unique<Softmax<float>>()); break;
+            case LayerKind::LeakyReLU:
+                restored.add_layer(std::make_unique<LeakyReLU<float>>(std::bit_cast<float>(record.param)));
+                break;
+            default: throw std::runtime_error("Corrupt checkpoint: unknown layer type");
+        }
+    }
+
+    const auto arena = restored.parameter_values();
+    for (const auto& copy : copies) {
+        const auto& dense = static_cast<const Dense<float>&>(restored.layer(copy.layer));
+        const auto w = dense.weights(), b = dense.bias();
+        std::memcpy(arena.data() + (w.data() - arena.data()), copy.w, w.size_bytes());
+        std::memcpy(arena.data() + (b.data() - arena.data()), copy.b, b.size_bytes());
+    }
+
+    if (header.hashing) loader.set_hashing(hashing);
+    else loader.set_vocabulary(Vocabulary(words));
+    model = std::move(restored);
+}
@@ -0,0 +1,45 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef MODELCHECKPOINT_H
+#define MODELCHECKPOINT_H
+
+#include "TextLoader.h"
+#include "neural_network.h"
+#include <string>
+#include <cstdint>
+
+namespace utec::data {
+
+    // Checkpoint binario de un modelo entrenado: la pila de capas (pesos y
+    // bias de cada Dense, tipo de cada activación) más el vectorizador del
+    // TextLoader (vocabulario o configuración de hashing).
+    //
+    // Formato (little-endian, versión 1): cabecera fija, tabla de capas y
+    // luego las secciones de datos, cada una alineada a 64 bytes para que los
+    // pesos se puedan usar directamente desde el archivo proyectado con mmap.
+    // Así un proceso de scoring arranca en milisegundos y varios procesos
+    // comparten la misma copia de los pesos en el page cache
+    class ModelCheckpoint {
+    public:
+        static constexpr std::uint32_t format_version = 1;
+
+        // Escribe a un temporal y lo renombra sobre path: un lector nunca ve
+        // un checkpoint a medio escribir
+        static void save(const std::string& path,
+                         const utec::neural_network::NeuralNetwork<float>& model,
+                         const TextLoader& loader);
+
+        // Reemplaza model y el vectorizador de loader. Con mapped = true las
+        // capas Dense leen los pesos del archivo proyectado (solo inferencia);
+        // con false se copian a capas Dense normales que se pueden seguir entrenando
+        static void load(const std::string& path,
+                         utec::neural_network::NeuralNetwork<float>& model,
+                         TextLoader& loader,
+                         bool mapped = true);
+    };
+
+}
+
+#endif //MODELCHECKPOINT_H
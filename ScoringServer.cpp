@@ -0,0 +1,376 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#include "ScoringServer.h"
+#include "tensor_sparse.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define UTEC_HAS_SOCKETS 1
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace utec::app;
+using namespace utec::data;
+using namespace utec::neural_network;
+
+size_t utec::app::format_score(float score, bool logits, char (&out)[32]) {
+    const float p = logits ? 1.0f / (1.0f + std::exp(-score)) : score;
+    return static_cast<size_t>(std::snprintf(out, sizeof(out), "%.6f\t%s\n", p, p >= 0.5f ? "spam" : "ham"));
+}
+
+#ifdef UTEC_HAS_SOCKETS
+
+namespace {
+
+    bool write_all(int fd, const char* data, size_t size) {
+        while (size > 0) {
+#ifdef MSG_NOSIGNAL
+            ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL); // cliente caído: error, no SIGPIPE
+            if (n < 0 && errno == ENOTSOCK) n = ::write(fd, data, size);
+#else
+            ssize_t n = ::write(fd, data, size);
+#endif
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    void make_pipe(int fds[2]) {
+        if (::pipe(fds) != 0) throw std::runtime_error("Cannot create pipe");
+        for (int i = 0; i < 2; ++i) ::fcntl(fds[i], F_SETFL, ::fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+    }
+
+    void close_pipe(int fds[2]) {
+        for (int i = 0; i < 2; ++i)
+            if (fds[i] >= 0) ::close(std::exchange(fds[i], -1));
+    }
+
+    void drain_pipe(int fd) {
+        char buffer[64];
+        while (::read(fd, buffer, sizeof(buffer)) > 0) {}
+    }
+
+}
+
+// Una conexión: el hilo de la conexión lee y vectoriza los pedidos; el hilo
+// de scoring deja las respuestas en outbox y lo despierta con un byte en wake
+struct ScoringServer::Connection {
+    int in_fd;
+    int out_fd;
+    bool owned; // socket aceptado: se cierra con la conexión
+    int wake[2] = {-1, -1};
+    std::mutex mutex;
+    std::string outbox;
+    size_t pending = 0;
+    std::atomic<bool> finished{false};
+
+    Connection(int in, int out, bool owns) : in_fd(in), out_fd(out), owned(owns) {
+        make_pipe(wake);
+    }
+
+    ~Connection() {
+        close_pipe(wake);
+        if (owned) ::close(in_fd);
+    }
+
+    void deliver(const char* reply, size_t size) {
+        bool was_empty;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            was_empty = outbox.empty();
+            outbox.append(reply, size);
+            --pending;
+        }
+        // Un byte basta mientras outbox no se haya vaciado
+        if (was_empty) (void)!::write(wake[1], "", 1);
+    }
+};
+
+ScoringServer::ScoringServer(const NeuralNetwork<float>& model, const TextLoader& loader, ServerConfig config)
+    : model_(model), loader_(loader), config_(config) {
+    if (config_.max_batch == 0) throw std::invalid_argument("max_batch must be positive");
+    scorer_ = std::thread([this] { score_loop(); });
+}
+
+ScoringServer::~ScoringServer() {
+    stop();
+}
+
+void ScoringServer::listen(const std::string& socket_path) {
+    if (stopping_) throw std::logic_error("Server already stopped");
+    if (listen_fd_ >= 0) throw std::logic_error("Server is already listening");
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path))
+        throw std::invalid_argument("Bad socket path: " + socket_path);
+    std::copy(socket_path.begin(), socket_path.end(), address.sun_path);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error("Cannot create socket");
+    ::unlink(socket_path.c_str());
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(fd, SOMAXCONN) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot listen on " + socket_path);
+    }
+    make_pipe(stop_pipe_);
+    listen_fd_ = fd;
+    socket_path_ = socket_path;
+    acceptor_ = std::thread([this] { accept_loop(); });
+}
+
+void ScoringServer::serve_stream(int in_fd, int out_fd) {
+    if (stopping_) throw std::logic_error("Server already stopped");
+    run_connection(std::make_shared<Connection>(in_fd, out_fd, false));
+}
+
+void ScoringServer::stop() {
+    if (stopping_.exchange(true)) return;
+    if (acceptor_.joinable()) {
+        (void)!::write(stop_pipe_[1], "", 1);
+        acceptor_.join();
+    }
+    if (listen_fd_ >= 0) {
+        ::close(std::exchange(listen_fd_, -1));
+        ::unlink(socket_path_.c_str());
+    }
+    close_pipe(stop_pipe_);
+
+    // Cada conexión ve fin de entrada, termina de responder lo pendiente y sale
+    std::list<Worker> workers;
+    {
+        std::lock_guard<std::mutex> lock(workers_mutex_);
+        for (auto& worker : workers_) ::shutdown(worker.connection->in_fd, SHUT_RD);
+        workers.swap(workers_);
+    }
+    for (auto& worker : workers) worker.thread.join();
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        scorer_stop_ = true;
+    }
+    queue_ready_.notify_one();
+    scorer_.join();
+}
+
+void ScoringServer::accept_loop() {
+    while (true) {
+        pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {stop_pipe_[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents) return;
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) continue; // EINTR, ECONNABORTED, ...
+        reap_workers();
+        std::shared_ptr<Connection> connection;
+        try {
+            connection = std::make_shared<Connection>(fd, fd, true);
+        } catch (const std::exception&) {
+            ::close(fd);
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(workers_mutex_);
+        workers_.push_back({std::thread([this, connection] {
+            run_connection(connection);
+            // El cliente ve el fin ya; el descriptor se cierra al juntar el hilo
+            ::shutdown(connection->in_fd, SHUT_RDWR);
+            connection->finished = true;
+        }), connection});
+    }
+}
+
+// Junta los hilos de conexiones ya cerradas, para no acumularlos
+void ScoringServer::reap_workers() {
+    std::lock_guard<std::mutex> lock(workers_mutex_);
+    for (auto it = workers_.begin(); it != workers_.end();) {
+        if (!it->connection->finished) {
+            ++it;
+            continue;
+        }
+        it->thread.join();
+        it = workers_.erase(it);
+    }
+}
+
+void ScoringServer::run_connection(const std::shared_ptr<Connection>& connection) {
+    Connection& c = *connection;
+    std::vector<char> buffer(64 * 1024);
+    std::string inbox, outgoing;
+    bool eof = false, broken = false;
+    bool skipping = false; // resto de una línea ya cortada y respondida
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(c.mutex);
+            if (eof && c.pending == 0 && c.outbox.empty()) break;
+        }
+        pollfd fds[2] = {{eof ? -1 : c.in_fd, POLLIN, 0}, {c.wake[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[1].revents) {
+            drain_pipe(c.wake[0]);
+            {
+                std::lock_guard<std::mutex> lock(c.mutex);
+                outgoing.swap(c.outbox);
+            }
+            // Si el cliente ya no lee, las respuestas se descartan
+            if (!broken && !write_all(c.out_fd, outgoing.data(), outgoing.size())) broken = true;
+            outgoing.clear();
+        }
+
+        if (!eof && fds[0].revents) {
+            const ssize_t n = ::read(c.in_fd, buffer.data(), buffer.size());
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                eof = true;
+                if (!inbox.empty()) enqueue(connection, inbox); // última línea sin '\n'
+                continue;
+            }
+            inbox.append(buffer.data(), static_cast<size_t>(n));
+            size_t start = 0;
+            if (skipping) {
+                const size_t newline = inbox.find('\n');
+                if (newline == std::string::npos) {
+                    inbox.clear();
+                    continue;
+                }
+                start = newline + 1;
+                skipping = false;
+            }
+            for (size_t end; (end = inbox.find('\n', start)) != std::string::npos; start = end + 1) {
+                std::string_view line(inbox.data() + start, end - start);
+                if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+                enqueue(connection, line);
+            }
+            inbox.erase(0, start);
+            // Línea demasiado larga: se puntúa cortada y lo que queda hasta el
+            // '\n' se descarta, así cada línea tiene una sola respuesta
+            if (inbox.size() > config_.max_line) {
+                enqueue(connection, std::string_view(inbox).substr(0, config_.max_line));
+                inbox.clear();
+                skipping = true;
+            }
+        }
+    }
+}
+
+void ScoringServer::enqueue(const std::shared_ptr<Connection>& connection, std::string_view message) {
+    auto features = loader_.vectorize_sparse(message);
+    {
+        std::lock_guard<std::mutex> lock(connection->mutex);
+        ++connection->pending;
+    }
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queue_.push_back({connection, std::move(features), std::chrono::steady_clock::now()});
+        // El primero fija el plazo del batch; al completarlo no hace falta esperar
+        wake = queue_.size() == 1 || queue_.size() == config_.max_batch;
+    }
+    if (wake) queue_ready_.notify_one();
+}
+
+void ScoringServer::score_loop() {
+    std::vector<Request> batch;
+    char reply[32];
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while (true) {
+        queue_ready_.wait(lock, [&] { return scorer_stop_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        const auto deadline = queue_.front().arrival + config_.max_delay;
+        queue_ready_.wait_until(lock, deadline, [&] {
+            return scorer_stop_ || queue_.size() >= config_.max_batch;
+        });
+        const size_t n = std::min(config_.max_batch, queue_.size());
+        batch.clear();
+        std::move(queue_.begin(), queue_.begin() + static_cast<std::ptrdiff_t>(n), std::back_inserter(batch));
+        queue_.erase(queue_.begin(), queue_.begin() + static_cast<std::ptrdiff_t>(n));
+        lock.unlock();
+
+        CsrMatrix<float> input(loader_.get_feature_size());
+        for (const auto& request : batch) {
+            const auto& f = request.features;
+            input.push_row(f.indices.data(), f.values.data(), f.indices.size());
+        }
+        const auto scores = model_.infer(input);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const size_t size = format_score(scores(i, 0), config_.logits, reply);
+            batch[i].connection->deliver(reply, size);
+        }
+        requests_ += batch.size();
+        ++batches_;
+        batch.clear(); // suelta las conexiones antes de volver a esperar
+        lock.lock();
+    }
+}
+
+namespace {
+    int signal_pipe[2] = {-1, -1};
+
+    extern "C" void on_shutdown_signal(int) {
+        (void)!::write(signal_pipe[1], "", 1);
+    }
+}
+
+void utec::app::wait_for_shutdown_signal() {
+    make_pipe(signal_pipe);
+    struct sigaction action{};
+    action.sa_handler = on_shutdown_signal;
+    sigemptyset(&action.sa_mask);
+    struct sigaction old_int{}, old_term{};
+    ::sigaction(SIGINT, &action, &old_int);
+    ::sigaction(SIGTERM, &action, &old_term);
+
+    pollfd fd{signal_pipe[0], POLLIN, 0};
+    while (::poll(&fd, 1, -1) < 0 && errno == EINTR) {}
+
+    ::sigaction(SIGINT, &old_int, nullptr);
+    ::sigaction(SIGTERM, &old_term, nullptr);
+    close_pipe(signal_pipe);
+}
+
+#else
+
+struct ScoringServer::Connection {};
+
+ScoringServer::ScoringServer(const NeuralNetwork<float>& model, const TextLoader& loader, ServerConfig config)
+    : model_(model), loader_(loader), config_(config) {}
+
+ScoringServer::~ScoringServer() = default;
+
+void ScoringServer::listen(const std::string&) {
+    throw std::runtime_error("The scoring server needs POSIX sockets");
+}
+
+void ScoringServer::serve_stream(int, int) {
+    throw std::runtime_error("The scoring server needs POSIX sockets");
+}
+
+void ScoringServer::stop() {}
+
+void utec::app::wait_for_shutdown_signal() {
+    throw std::runtime_error("The scoring server needs POSIX sockets");
+}
+
+#endif
@@ -0,0 +1,120 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef SCORINGSERVER_H
+#define SCORINGSERVER_H
+
+#include "TextLoader.h"
+#include "neural_network.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace utec::app {
+
+    struct ServerConfig {
+        size_t max_batch = 64;                      // mensajes por forward
+        std::chrono::microseconds max_delay{1000};  // espera máxima para completar un batch
+        bool logits = true;                         // la red entrega logits: se responde sigmoid(z)
+        size_t max_line = 1 << 20;                  // una línea más larga se puntúa cortada a este largo
+    };
+
+    // Servidor de scoring no interactivo. Protocolo de líneas: cada línea
+    // recibida es un mensaje y por cada una se responde, en el mismo orden,
+    // "<probabilidad>\t<spam|ham>\n". Un cliente puede enviar varias líneas
+    // sin esperar las respuestas.
+    //
+    // Cada conexión tokeniza y vectoriza en su propio hilo; un único hilo de
+    // scoring junta los mensajes de todas las conexiones en micro-batches
+    // (hasta max_batch, o lo que haya cuando el más antiguo cumple max_delay)
+    // y hace un solo forward por batch sobre el modelo compartido, que solo se
+    // lee. Al ser uno, los batches salen en orden y cada conexión recibe sus
+    // respuestas en el orden de sus pedidos
+    class ScoringServer {
+    public:
+        struct Stats {
+            size_t requests = 0;
+            size_t batches = 0;
+        };
+
+        // model y loader deben seguir vivos y sin cambios mientras el servidor exista
+        ScoringServer(const utec::neural_network::NeuralNetwork<float>& model,
+                      const utec::data::TextLoader& loader,
+                      ServerConfig config = {});
+        ~ScoringServer();
+
+        ScoringServer(const ScoringServer&) = delete;
+        ScoringServer& operator=(const ScoringServer&) = delete;
+
+        // Escucha en un socket Unix (se reemplaza si ya existe) y atiende en
+        // segundo plano hasta stop()
+        void listen(const std::string& socket_path);
+
+        // Atiende una sola conexión en el hilo que llama (p. ej. stdin/stdout)
+        // y retorna cuando in_fd llega al final y se respondió todo
+        void serve_stream(int in_fd, int out_fd);
+
+        // Deja de aceptar, responde lo pendiente y cierra las conexiones
+        void stop();
+
+        Stats stats() const { return {requests_.load(), batches_.load()}; }
+
+    private:
+        struct Connection;
+        struct Request {
+            std::shared_ptr<Connection> connection;
+            utec::data::SparseVector features;
+            std::chrono::steady_clock::time_point arrival;
+        };
+        struct Worker {
+            std::thread thread;
+            std::shared_ptr<Connection> connection;
+        };
+
+        const utec::neural_network::NeuralNetwork<float>& model_;
+        const utec::data::TextLoader& loader_;
+        ServerConfig config_;
+
+        std::mutex queue_mutex_;
+        std::condition_variable queue_ready_;
+        std::deque<Request> queue_;
+        bool scorer_stop_ = false;
+        std::thread scorer_;
+
+        std::mutex workers_mutex_;
+        std::list<Worker> workers_;
+        int listen_fd_ = -1;
+        int stop_pipe_[2] = {-1, -1}; // despierta a accept_loop en stop()
+        std::string socket_path_;
+        std::atomic<bool> stopping_{false};
+        std::thread acceptor_;
+
+        std::atomic<size_t> requests_{0};
+        std::atomic<size_t> batches_{0};
+
+        void score_loop();
+        void accept_loop();
+        void run_connection(const std::shared_ptr<Connection>& connection);
+        void enqueue(const std::shared_ptr<Connection>& connection, std::string_view message);
+        void reap_workers();
+    };
+
+    // Respuesta por mensaje, la misma del servidor y de `main classify`:
+    // "<probabilidad>\t<spam|ham>\n". Con logits se aplica la sigmoide.
+    // Devuelve los bytes escritos en out
+    size_t format_score(float score, bool logits, char (&out)[32]);
+
+    // Bloquea hasta recibir SIGINT o SIGTERM (para `main serve`)
+    void wait_for_shutdown_signal();
+
+}
+
+#endif //SCORINGSERVER_H
@@ -0,0 +1,202 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TextLoader.h"
+#include "DatasetUtils.h"
+#include "ScoringServer.h"
+#include "neural_network.h"
+#include "nn_dense.h"
+#include "nn_activation.h"
+#include "nn_loss.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace utec::app;
+using namespace utec::data;
+using namespace utec::neural_network;
+
+using clock_type = std::chrono::steady_clock;
+
+// Misma arquitectura y entrenamiento que AppManager
+NeuralNetwork<float> train_model(TextLoader& loader) {
+    loader.load_data();
+    auto X = DatasetUtils::vector_to_csr(loader.get_dataset());
+    auto Y = DatasetUtils::labels_to_tensor(loader.get_dataset());
+
+    auto init_w = [](Tensor<float, 2>& W) { W.fill(0.01f); };
+    auto init_b = [](Tensor<float, 2>& b) { b.fill(0.0f); };
+    NeuralNetwork<float> model;
+    model.add_layer(std::make_unique<Dense<float>>(loader.get_feature_size(), 16, init_w, init_b));
+    model.add_layer(std::make_unique<ReLU<float>>());
+    model.add_layer(std::make_unique<Dense<float>>(16, 1, init_w, init_b));
+    model.train<SigmoidBCEWithLogits>(X, Y, 20, 8, 0.1f);
+    return model;
+}
+
+// Texto de cada línea del CSV después de la primera coma (basta como carga)
+std::vector<std::string> read_messages(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> messages;
+    std::string line;
+    std::getline(in, line); // cabecera
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        const size_t comma = line.find(',');
+        if (comma != std::string::npos) messages.push_back(line.substr(comma + 1));
+    }
+    return messages;
+}
+
+// La respuesta que el servidor debería dar a cada mensaje, puntuado aquí mismo
+std::vector<std::string> expected_replies(const NeuralNetwork<float>& model, const TextLoader& loader,
+                                          const std::vector<std::string>& messages) {
+    CsrMatrix<float> input(loader.get_feature_size());
+    for (const auto& m : messages) {
+        auto v = loader.vectorize_sparse(m);
+        input.push_row(v.indices.data(), v.values.data(), v.indices.size());
+    }
+    const auto scores = model.predict(input);
+    std::vector<std::string> replies;
+    char reply[32];
+    for (size_t i = 0; i < messages.size(); ++i)
+        replies.emplace_back(reply, format_score(scores(i, 0), true, reply) - 1); // sin '\n'
+    return replies;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+struct ClientResult {
+    std::vector<double> latencies_us;
+    size_t mismatches = 0;
+};
+
+// Cliente de lazo cerrado: mantiene hasta `depth` mensajes en vuelo y mide
+// cada uno desde que se envía hasta que llega su respuesta
+ClientResult run_client(const std::string& path, const std::vector<std::string>& messages,
+                        const std::vector<std::string>& expected, size_t offset, size_t count, size_t depth) {
+    ClientResult result;
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "No se pudo conectar a " << path << "\n";
+        result.mismatches = count;
+        if (fd >= 0) ::close(fd);
+        return result;
+    }
+
+    std::deque<clock_type::time_point> in_flight;
+    std::string inbox, line;
+    char buffer[64 * 1024];
+    size_t sent = 0, received = 0;
+    while (received < count) {
+        while (sent < count && in_flight.size() < depth) {
+            line = messages[(offset + sent) % messages.size()] + "\n";
+            in_flight.push_back(clock_type::now());
+            for (size_t done = 0; done < line.size();) {
+                const ssize_t n = ::write(fd, line.data() + done, line.size() - done);
+                if (n <= 0) { ::close(fd); result.mismatches += count - received; return result; }
+                done += static_cast<size_t>(n);
+            }
+            ++sent;
+        }
+        const ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n <= 0) break;
+        inbox.append(buffer, static_cast<size_t>(n));
+        size_t start = 0;
+        for (size_t end; (end = inbox.find('\n', start)) != std::string::npos; start = end + 1) {
+            const auto now = clock_type::now();
+            result.latencies_us.push_back(std::chrono::duration<double, std::micro>(now - in_flight.front()).count());
+            in_flight.pop_front();
+            if (inbox.compare(start, end - start, expected[(offset + received) % expected.size()]) != 0)
+                ++result.mismatches;
+            ++received;
+        }
+        inbox.erase(0, start);
+    }
+    result.mismatches += count - received;
+    ::close(fd);
+    return result;
+}
+
+double percentile(std::vector<double>& values, double q) {
+    if (values.empty()) return 0;
+    const size_t k = std::min(values.size() - 1, static_cast<size_t>(q * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(k), values.end());
+    return values[k];
+}
+
+// Uso: ServerBenchmark [clientes] [mensajes por cliente] [en vuelo por cliente]
+int main(int argc, char* argv[]) {
+    const size_t clients = argc > 1 ? std::stoul(argv[1]) : 8;
+    const size_t per_client = argc > 2 ? std::stoul(argv[2]) : 5000;
+    const size_t depth = argc > 3 ? std::stoul(argv[3]) : 8;
+    const std::string path = "server_benchmark.sock";
+
+    TextLoader loader("training_words_eng.csv");
+    const auto model = train_model(loader);
+    const auto messages = read_messages("training_words_eng.csv");
+    const auto expected = expected_replies(model, loader, messages);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Clientes " << clients << ", mensajes por cliente " << per_client
+              << ", en vuelo por cliente " << depth << "\n";
+
+    struct Setting { size_t max_batch; size_t max_delay_us; };
+    for (const Setting setting : {Setting{1, 0}, Setting{16, 200}, Setting{64, 1000}}) {
+        ServerConfig config;
+        config.max_batch = setting.max_batch;
+        config.max_delay = std::chrono::microseconds(setting.max_delay_us);
+        ScoringServer server(model, loader, config);
+        server.listen(path);
+
+        std::vector<ClientResult> results(clients);
+        std::vector<std::thread> threads;
+        const auto start = clock_type::now();
+        for (size_t c = 0; c < clients; ++c)
+            threads.emplace_back([&, c] {
+                results[c] = run_client(path, messages, expected, c * 997, per_client, depth);
+            });
+        for (auto& t : threads) t.join();
+        const double elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+        server.stop();
+
+        std::vector<double> latencies;
+        size_t mismatches = 0;
+        for (auto& r : results) {
+            latencies.insert(latencies.end(), r.latencies_us.begin(), r.latencies_us.end());
+            mismatches += r.mismatches;
+        }
+        const auto stats = server.stats();
+        const double total = static_cast<double>(clients * per_client);
+        std::cout << "batch max " << std::setw(3) << setting.max_batch
+                  << ", espera " << std::setw(5) << setting.max_delay_us << " us: "
+                  << std::setw(10) << total / elapsed << " msg/s"
+                  << "  | p50 " << std::setw(8) << percentile(latencies, 0.50) << " us"
+                  << "  p99 " << std::setw(8) << percentile(latencies, 0.99) << " us"
+                  << "  | batch medio " << std::setw(5)
+                  << static_cast<double>(stats.requests) / static_cast<double>(std::max<size_t>(stats.batches, 1))
+                  << "  | mismas respuestas " << (mismatches == 0 ? "si" : "NO") << "\n";
+    }
+    return 0;
+}
+
+#else
+
+int main() {
+    std::cout << "ServerBenchmark necesita sockets POSIX\n";
+    return 0;
+}
+
+#endif
@@ -0,0 +1,269 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <functional>
+#include <span>
+#include <vector>
+#include "tensor.h"
+#include "tensor_math.h"
+
+using namespace utec::algebra;
+
+// Implementación anterior de matrix_product (índice plano -> coordenadas -> strides)
+// se mantiene aquí solo como referencia para comparar
+template<typename T>
+Tensor<T, 2> reference_matrix_product(const Tensor<T, 2>& A, const Tensor<T, 2>& B) {
+    const size_t M = A.shape()[0], K = A.shape()[1], N = B.shape()[1];
+    Tensor<T, 2> C(M, N);
+    for (size_t i = 0; i < M * N; ++i) {
+        size_t row = i / N, col = i % N;
+        T sum = T{};
+        for (size_t k = 0; k < K; ++k) sum += A(row, k) * B(k, col);
+        C(row, col) = sum;
+    }
+    return C;
+}
+
+// Operadores element-wise anteriores: cada operación crea un Tensor, llama a un
+// std::function por elemento y decodifica coordenadas para el broadcasting
+template<typename T>
+Tensor<T, 2> reference_apply(const Tensor<T, 2>& A, const Tensor<T, 2>& B, const std::function<T(T, T)>& op) {
+    Tensor<T, 2> C(A.shape()[0], A.shape()[1]);
+    const size_t cols = A.shape()[1];
+    for (size_t i = 0; i < C.size(); ++i) {
+        std::array<size_t, 2> idx{i / cols, i % cols};
+        C(idx[0], idx[1]) = op(A(idx[0], idx[1]), B(idx[0], idx[1]));
+    }
+    return C;
+}
+
+template<typename T>
+Tensor<T, 2> reference_scale(const Tensor<T, 2>& A, T scalar) {
+    Tensor<T, 2> C = A;
+    for (auto it = C.begin(); it != C.end(); ++it) *it = *it * scalar;
+    return C;
+}
+
+// Broadcasting anterior de Tensor::apply: decodifica la coordenada de cada
+// elemento con % y / y recorre los strides de cada operando por separado
+template<typename T, size_t Rank>
+Tensor<T, Rank> reference_broadcast(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B, const std::function<T(T, T)>& op) {
+    auto shape = Tensor<T, Rank>::broadcast_shape(A.shape(), B.shape());
+    Tensor<T, Rank> C;
+    std::apply([&](auto... d) { C.reshape(d...); }, shape);
+    auto offset = [](const auto& dim, const std::array<size_t, Rank>& idx) {
+        size_t index = 0, stride = 1;
+        for (size_t r = Rank; r-- > 0;) {
+            index += (dim[r] == 1 ? 0 : idx[r]) * stride;
+            stride *= dim[r];
+        }
+        return index;
+    };
+    for (size_t i = 0; i < C.size(); ++i) {
+        std::array<size_t, Rank> idx{};
+        size_t rem = i;
+        for (size_t r = Rank; r-- > 0;) {
+            idx[r] = rem % shape[r];
+            rem /= shape[r];
+        }
+        C.begin()[i] = op(A.cbegin()[offset(A.shape(), idx)], B.cbegin()[offset(B.shape(), idx)]);
+    }
+    return C;
+}
+
+template<typename F>
+double seconds_per_call(F&& f) {
+    using clock = std::chrono::steady_clock;
+    size_t reps = 0;
+    auto start = clock::now();
+    double elapsed = 0;
+    do {
+        f();
+        ++reps;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < 0.3);
+    return elapsed / static_cast<double>(reps);
+}
+
+Tensor<float, 2> random_tensor(size_t rows, size_t cols, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    Tensor<float, 2> t(rows, cols);
+    for (auto it = t.begin(); it != t.end(); ++it) *it = dist(rng);
+    return t;
+}
+
+void bench_gemm(size_t M, size_t K, size_t N, std::mt19937& rng) {
+    auto A = random_tensor(M, K, rng);
+    auto B = random_tensor(K, N, rng);
+    const double flops = 2.0 * M * N * K;
+
+    Tensor<float, 2> fast, slow;
+    double t_fast = seconds_per_call([&] { fast = matrix_product(A, B); });
+    double t_slow = seconds_per_call([&] { slow = reference_matrix_product(A, B); });
+
+    float max_err = 0;
+    for (size_t i = 0; i < fast.size(); ++i)
+        max_err = std::max(max_err, std::abs(fast.cbegin()[i] - slow.cbegin()[i]));
+
+    std::cout << std::setw(5) << M << " x " << std::setw(5) << K << " . " << std::setw(5) << K
+              << " x " << std::setw(5) << N
+              << "  | gemm " << std::setw(8) << flops / t_fast * 1e-9 << " GFLOP/s"
+              << "  | referencia " << std::setw(8) << flops / t_slow * 1e-9 << " GFLOP/s"
+              << "  | speedup " << std::setw(7) << t_slow / t_fast << "x"
+              << "  | max |err| " << max_err << "\n";
+}
+
+// Aᵗ * B (tn) o A * Bᵗ (nt) leyendo los operandos en su layout, contra
+// copiar la traspuesta con transpose_2d y luego multiplicar
+void bench_transposed(bool tn, size_t M, size_t K, size_t N, std::mt19937& rng) {
+    auto A = tn ? random_tensor(K, M, rng) : random_tensor(M, K, rng);
+    auto B = tn ? random_tensor(K, N, rng) : random_tensor(N, K, rng);
+    const double flops = 2.0 * M * N * K;
+
+    Tensor<float, 2> fast, slow;
+    double t_fast = seconds_per_call([&] { tn ? matmul_tn(A, B, fast) : matmul_nt(A, B, fast); });
+    double t_slow = seconds_per_call([&] {
+        slow = tn ? matrix_product(transpose_2d(A), B) : matrix_product(A, transpose_2d(B));
+    });
+
+    float max_err = 0;
+    for (size_t i = 0; i < fast.size(); ++i)
+        max_err = std::max(max_err, std::abs(fast.cbegin()[i] - slow.cbegin()[i]));
+
+    std::cout << (tn ? "matmul_tn " : "matmul_nt ") << std::setw(5) << M << " x " << std::setw(5) << K
+              << " . " << std::setw(5) << K << " x " << std::setw(5) << N
+              << "  | directo " << std::setw(8) << flops / t_fast * 1e-9 << " GFLOP/s"
+              << "  | transpose_2d " << std::setw(8) << flops / t_slow * 1e-9 << " GFLOP/s"
+              << "  | speedup " << std::setw(7) << t_slow / t_fast << "x"
+              << "  | max |err| " << max_err << "\n";
+}
+
+template<size_t Rank>
+Tensor<float, Rank> random_tensor(const std::array<size_t, Rank>& shape, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    Tensor<float, Rank> t;
+    std::apply([&](auto... d) { t.reshape(d...); }, shape);
+    for (auto it = t.begin(); it != t.end(); ++it) *it = dist(rng);
+    return t;
+}
+
+// A + B con B de forma b (dimensiones en 1 se repiten); A tiene la forma completa
+template<size_t Rank>
+void bench_broadcast(const char* pattern, const std::array<size_t, Rank>& a, const std::array<size_t, Rank>& b,
+                     std::mt19937& rng) {
+    auto A = random_tensor(a, rng);
+    auto B = random_tensor(b, rng);
+
+    Tensor<float, Rank> fast, slow;
+    double t_fast = seconds_per_call([&] { fast = A + B; });
+    double t_slow = seconds_per_call([&] { slow = reference_broadcast<float, Rank>(A, B, std::plus<float>()); });
+
+    float max_err = 0;
+    for (size_t i = 0; i < fast.size(); ++i)
+        max_err = std::max(max_err, std::abs(fast.cbegin()[i] - slow.cbegin()[i]));
+
+    const double elems = static_cast<double>(A.size());
+    std::cout << "rank " << Rank << "  " << std::left << std::setw(18) << pattern << std::right
+              << "  | motor " << std::setw(8) << elems / t_fast * 1e-9 << " Gelem/s"
+              << "  | anterior " << std::setw(8) << elems / t_slow * 1e-9 << " Gelem/s"
+              << "  | speedup " << std::setw(7) << t_slow / t_fast << "x"
+              << "  | max |err| " << max_err << "\n";
+}
+
+// (y_pred - y_true) * s, como en MSELoss::loss_gradient
+void bench_elementwise(size_t rows, size_t cols, std::mt19937& rng) {
+    auto A = random_tensor(rows, cols, rng);
+    auto B = random_tensor(rows, cols, rng);
+    const float s = 0.5f;
+
+    Tensor<float, 2> fused, slow;
+    double t_fused = seconds_per_call([&] { fused = (A - B) * s; });
+    double t_slow = seconds_per_call([&] {
+        slow = reference_scale(reference_apply<float>(A, B, [](float a, float b) { return a - b; }), s);
+    });
+
+    float max_err = 0;
+    for (size_t i = 0; i < fused.size(); ++i)
+        max_err = std::max(max_err, std::abs(fused.cbegin()[i] - slow.cbegin()[i]));
+
+    const double bytes = 3.0 * rows * cols * sizeof(float);
+    std::cout << std::setw(5) << rows << " x " << std::setw(5) << cols
+              << "  | (A - B) * s fusionado " << std::setw(8) << bytes / t_fused * 1e-9 << " GB/s"
+              << "  | anterior " << std::setw(8) << bytes / t_slow * 1e-9 << " GB/s"
+              << "  | speedup " << std::setw(7) << t_slow / t_fused << "x"
+              << "  | max |err| " << max_err << "\n";
+}
+
+// exp/log/sigmoid/tanh de tensor_math.h contra un loop con las funciones de libm
+void bench_math(const char* name, void (*fast)(std::span<const float>, std::span<float>),
+                float (*reference)(float), float lo, float hi, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(lo, hi);
+    std::vector<float> x(1 << 20), y_fast(x.size()), y_slow(x.size());
+    for (auto& v : x) v = dist(rng);
+
+    double t_fast = seconds_per_call([&] { fast(x, y_fast); });
+    double t_slow = seconds_per_call([&] {
+        for (size_t i = 0; i < x.size(); ++i) y_slow[i] = reference(x[i]);
+    });
+
+    float max_rel = 0;
+    for (size_t i = 0; i < x.size(); ++i)
+        if (y_slow[i] != 0) max_rel = std::max(max_rel, std::abs((y_fast[i] - y_slow[i]) / y_slow[i]));
+
+    const double elems = static_cast<double>(x.size());
+    std::cout << std::left << std::setw(8) << name << std::right
+              << "  | vmath " << std::setw(8) << elems / t_fast * 1e-9 << " Gelem/s"
+              << "  | libm " << std::setw(8) << elems / t_slow * 1e-9 << " Gelem/s"
+              << "  | speedup " << std::setw(7) << t_slow / t_fast << "x"
+              << "  | max err rel " << std::scientific << max_rel << std::fixed << "\n";
+}
+
+int main() {
+    std::mt19937 rng(42);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "GEMM micro-kernel: " << gemm::active_kernel<float>().name
+              << " (N <= 16: " << gemm::active_kernel<float>(true).name << ")\n";
+
+    bench_gemm(8, 7000, 16, rng);     // forward de la primera capa Dense
+    bench_gemm(7000, 8, 16, rng);     // dW = Xt * dZ
+    bench_gemm(8, 16, 7000, rng);     // dX = dZ * Wt
+    bench_gemm(256, 256, 256, rng);
+    bench_gemm(512, 512, 512, rng);
+
+    bench_transposed(true, 7000, 8, 16, rng);    // dW = Xt * dZ
+    bench_transposed(false, 8, 16, 7000, rng);   // dX = dZ * Wt
+    bench_transposed(true, 256, 256, 256, rng);
+    bench_transposed(false, 256, 256, 256, rng);
+
+    std::cout << "Funciones vectorizadas: " << vmath::active_kernels().name << "\n";
+    bench_math("exp", vmath::exp<float>, [](float v) { return std::exp(v); }, -80.0f, 80.0f, rng);
+    bench_math("log", vmath::log<float>, [](float v) { return std::log(v); }, 1e-6f, 1e6f, rng);
+    bench_math("sigmoid", vmath::sigmoid<float>, [](float v) { return 1.0f / (1.0f + std::exp(-v)); }, -20.0f, 20.0f, rng);
+    bench_math("tanh", vmath::tanh<float>, [](float v) { return std::tanh(v); }, -10.0f, 10.0f, rng);
+
+    bench_elementwise(256, 1, rng);       // gradiente de la pérdida por batch
+    bench_elementwise(1024, 1024, rng);
+
+    using A2 = std::array<size_t, 2>;
+    bench_broadcast<2>("misma forma", A2{1024, 1024}, A2{1024, 1024}, rng);
+    bench_broadcast<2>("fila (bias)", A2{1024, 1024}, A2{1, 1024}, rng);
+    bench_broadcast<2>("columna", A2{1024, 1024}, A2{1024, 1}, rng);
+    bench_broadcast<2>("escalar", A2{1024, 1024}, A2{1, 1}, rng);
+
+    using A3 = std::array<size_t, 3>;
+    bench_broadcast<3>("misma forma", A3{32, 128, 256}, A3{32, 128, 256}, rng);
+    bench_broadcast<3>("batch", A3{32, 128, 256}, A3{1, 128, 256}, rng);
+    bench_broadcast<3>("fila", A3{32, 128, 256}, A3{32, 1, 256}, rng);
+    bench_broadcast<3>("columna", A3{32, 128, 256}, A3{32, 128, 1}, rng);
+    bench_broadcast<3>("escalar", A3{32, 128, 256}, A3{1, 1, 1}, rng);
+
+    using A4 = std::array<size_t, 4>;
+    bench_broadcast<4>("misma forma", A4{8, 16, 64, 128}, A4{8, 16, 64, 128}, rng);
+    bench_broadcast<4>("plano (1,1,H,W)", A4{8, 16, 64, 128}, A4{1, 1, 64, 128}, rng);
+    bench_broadcast<4>("canal (1,C,1,1)", A4{8, 16, 64, 128}, A4{1, 16, 1, 1}, rng);
+    bench_broadcast<4>("columna", A4{8, 16, 64, 128}, A4{8, 16, 64, 1}, rng);
+    bench_broadcast<4>("escalar", A4{8, 16, 64, 128}, A4{1, 1, 1, 1}, rng);
+    return 0;
+}
@@ -3,111 +3,308 @@
 //
 
 #include "TextLoader.h"
-#include <fstream>
-#include <sstream>
+#include "MappedFile.h"
+#include "Tokenizer.h"
+#include "thread_pool.h"
 #include <iostream>
-#include <unordered_set>
 #include <algorithm>
+#include <iterator>
+#include <stdexcept>
 
 using namespace utec::data;
 
-TextLoader::TextLoader(const std::string& filename) : filename_(filename) {}
+namespace {
+
+    // Lee un campo CSV desde pos. Si está entre comillas devuelve su contenido
+    // (las comillas dobles "" quedan tal cual, el tokenizador las descarta);
+    // si no, termina en la primera coma o fin de línea (o de registro si to_eol)
+    std::string_view read_field(std::string_view data, size_t& pos, bool to_eol) {
+        if (pos < data.size() && data[pos] == '"') {
+            const size_t begin = ++pos;
+            while (pos < data.size()) {
+                if (data[pos] == '"') {
+                    if (pos + 1 < data.size() && data[pos + 1] == '"') {
+                        pos += 2;
+                        continue;
+                    }
+                    break;
+                }
+                ++pos;
+            }
+            std::string_view field = data.substr(begin, pos - begin);
+            if (pos < data.size()) ++pos; // comilla de cierre
+            return field;
+        }
 
-void TextLoader::load_data() {
-    std::ifstream file(filename_);
-    if (!file.is_open()) {
-        std::cerr << "No se pudo abrir el archivo: " << filename_ << std::endl;
-        return;
+        const size_t begin = pos;
+        while (pos < data.size() && data[pos] != '\n' && (to_eol || data[pos] != ',')) ++pos;
+        size_t end = pos;
+        if (end > begin && data[end - 1] == '\r') --end;
+        return data.substr(begin, end - begin);
     }
 
-    std::string line;
-
-    // Primer recorrido: construir vocabulario
-    build_vocabulary();
+    // FNV-1a de 64 bits. Los bits se reparten después, al pasar por mix en hash_features
+    std::uint64_t hash_token(std::string_view token) {
+        std::uint64_t h = 14695981039346656037ull;
+        for (unsigned char c : token) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
 
-    // Segundo recorrido: vectorizar mensajes
-    file.clear();
-    file.seekg(0); // Volver al inicio del archivo
+    void validate(const HashingConfig& hashing) {
+        if (hashing.bits == 0 || hashing.bits > 31)
+            throw std::invalid_argument("Hashing bits must be between 1 and 31");
+        if (hashing.max_ngram == 0)
+            throw std::invalid_argument("Hashing n-gram size must be at least 1");
+    }
 
-    // Ignorar cabecera
-    std::getline(file, line);
+    std::uint64_t mix(std::uint64_t h) {
+        h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 27; h *= 0x94d049bb133111ebull;
+        h ^= h >> 31;
+        return h;
+    }
 
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string label_text, message;
+    // Avanza hasta el inicio del siguiente registro (ignora columnas extra)
+    void skip_record(std::string_view data, size_t& pos) {
+        while (pos < data.size() && data[pos] != '\n') ++pos;
+        if (pos < data.size()) ++pos;
+    }
 
-        std::getline(ss, label_text, ',');
-        std::getline(ss, message);
+    // Registros [begin, end) del CSV que procesa un solo hilo en load_data
+    struct LoadChunk {
+        size_t begin = 0;
+        size_t end = 0;
+        std::vector<TextExample> examples;
+        // Vocabulario propio del bloque: ids locales por orden de primera aparición
+        std::unordered_map<std::string, std::uint32_t, StringHash, std::equal_to<>> vocabulary;
+        std::vector<std::string_view> words; // vistas a las claves de vocabulary
+        std::vector<std::uint32_t> global_ids; // id local -> id final
+    };
+
+    // Bloques de unos chunk_bytes cortados al final de un registro. Un campo
+    // entre comillas puede tener saltos de línea, así que no se puede saltar
+    // directo a un offset: se recorren los registros (mucho más barato que tokenizar)
+    std::vector<LoadChunk> split_records(std::string_view data, size_t pos, size_t chunk_bytes) {
+        std::vector<LoadChunk> chunks;
+        std::string_view label, message;
+        while (pos < data.size()) {
+            LoadChunk chunk;
+            chunk.begin = pos;
+            while (pos - chunk.begin < chunk_bytes && next_csv_record(data, pos, label, message)) {}
+            chunk.end = pos;
+            chunks.push_back(std::move(chunk));
+        }
+        return chunks;
+    }
 
-        TextExample example;
-        example.label = get_label(label_text);
-        example.vectorized_text = vectorize(message);
+}
 
-        dataset_.push_back(example);
+bool utec::data::next_csv_record(std::string_view data, size_t& pos, std::string_view& label, std::string_view& message) {
+    if (pos >= data.size()) return false;
+    label = read_field(data, pos, false);
+    message = {};
+    if (pos < data.size() && data[pos] == ',') {
+        ++pos;
+        message = read_field(data, pos, true);
     }
+    skip_record(data, pos);
+    return true;
+}
 
-    file.close();
+TextLoader::TextLoader(const std::string& filename) : filename_(filename) {}
+
+TextLoader::TextLoader(const std::string& filename, const HashingConfig& hashing)
+    : filename_(filename), hashing_(true), hashing_config_(hashing) {
+    validate(hashing);
 }
 
-void TextLoader::build_vocabulary() {
-    std::ifstream file(filename_);
-    std::string line;
+// El archivo proyectado en memoria se corta en bloques de registros que se
+// tokenizan y vectorizan en paralelo, cada uno con su vocabulario local. Los
+// vocabularios se unen después en el orden de los bloques, así cada palabra
+// recibe el id de su primera aparición en el archivo: los ids son los mismos
+// con cualquier cantidad de hilos. Al final se traducen los ids locales
+void TextLoader::load_data() {
+    MappedFile file(filename_);
+    if (!file.is_open()) {
+        std::cerr << "No se pudo abrir el archivo: " << filename_ << std::endl;
+        return;
+    }
 
-    // Ignorar cabecera
-    std::getline(file, line);
+    dataset_.clear();
+    vocabulary_ = Vocabulary();
 
-    std::unordered_set<std::string> unique_words;
+    const std::string_view data = file.view();
+    size_t pos = 0;
+    std::string_view label_text, message;
 
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string label_text, message;
+    // Ignorar cabecera
+    next_csv_record(data, pos, label_text, message);
+
+    // Varios bloques por hilo para repartir mejor la carga
+    const size_t chunk_bytes = std::max<size_t>(min_chunk_bytes, data.size() / (4 * num_threads_) + 1);
+    auto chunks = split_records(data, pos, chunk_bytes);
+    utec::parallel::ThreadPool pool(std::min(num_threads_, chunks.size()));
+
+    pool.parallel_for(chunks.size(), [&](size_t c) {
+        auto& chunk = chunks[c];
+        const std::string_view text = data.substr(0, chunk.end);
+        size_t at = chunk.begin;
+        std::string_view label, body;
+        std::string scratch;
+        std::vector<std::string_view> tokens;
+
+        while (next_csv_record(text, at, label, body)) {
+            tokenize(body, scratch, tokens);
+
+            TextExample example;
+            example.label = get_label(label);
+            if (hashing_) {
+                example.vectorized_text = hash_features(tokens);
+            } else {
+                // Por ahora indices guarda los ids locales de cada palabra, sin agrupar
+                auto& ids = example.vectorized_text.indices;
+                ids.reserve(tokens.size());
+                for (const auto& word : tokens) {
+                    auto it = chunk.vocabulary.find(word);
+                    if (it == chunk.vocabulary.end()) {
+                        const auto id = static_cast<std::uint32_t>(chunk.words.size());
+                        it = chunk.vocabulary.emplace(std::string(word), id).first;
+                        chunk.words.push_back(it->first);
+                    }
+                    ids.push_back(it->second);
+                }
+            }
+            chunk.examples.push_back(std::move(example));
+        }
+    });
+
+    if (!hashing_) {
+        std::unordered_map<std::string_view, std::uint32_t> ids;
+        std::vector<std::string_view> words; // vistas a las claves de los bloques
+        for (auto& chunk : chunks) {
+            chunk.global_ids.reserve(chunk.words.size());
+            for (const auto& word : chunk.words) {
+                const auto it = ids.emplace(word, static_cast<std::uint32_t>(words.size())).first;
+                if (it->second == words.size()) words.push_back(word);
+                chunk.global_ids.push_back(it->second);
+            }
+        }
+        vocabulary_ = Vocabulary(words);
+        pool.parallel_for(chunks.size(), [&](size_t c) {
+            auto& chunk = chunks[c];
+            for (auto& example : chunk.examples) {
+                auto& ids = example.vectorized_text.indices;
+                for (auto& id : ids) id = chunk.global_ids[id];
+                example.vectorized_text = to_sparse(ids);
+                example.vectorized_text.dimension = get_feature_size();
+            }
+            chunk.vocabulary.clear();
+        });
+    }
 
-        std::getline(ss, label_text, ',');
-        std::getline(ss, message);
+    size_t total = 0;
+    for (const auto& chunk : chunks) total += chunk.examples.size();
+    dataset_.reserve(total);
+    for (auto& chunk : chunks)
+        std::move(chunk.examples.begin(), chunk.examples.end(), std::back_inserter(dataset_));
+}
 
-        auto words = tokenize(message);
-        unique_words.insert(words.begin(), words.end());
+// Cada n-grama (n = 1..max_ngram) se combina a partir de los hashes de sus
+// palabras. Los bits bajos eligen el bucket y el bit más alto el signo
+SparseVector TextLoader::hash_features(const std::vector<std::string_view>& tokens) const {
+    const std::uint64_t mask = (std::uint64_t{1} << hashing_config_.bits) - 1;
+
+    std::vector<std::uint64_t> word_hashes(tokens.size());
+    for (size_t i = 0; i < tokens.size(); ++i) word_hashes[i] = hash_token(tokens[i]);
+
+    // clave = bucket << 1 | signo, así al ordenar quedan juntos los del mismo bucket
+    std::vector<std::uint64_t> keys;
+    keys.reserve(tokens.size() * hashing_config_.max_ngram);
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        std::uint64_t h = 0;
+        for (size_t n = 0; n < hashing_config_.max_ngram && i + n < tokens.size(); ++n) {
+            h = mix(h * 31 + word_hashes[i + n] + n);
+            const bool negative = hashing_config_.signed_hash && (h >> 63);
+            keys.push_back(((h & mask) << 1) | static_cast<std::uint64_t>(negative));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+
+    SparseVector result;
+    result.dimension = get_feature_size();
+    for (auto key : keys) {
+        const auto bucket = static_cast<std::uint32_t>(key >> 1);
+        const float value = (key & 1) ? -1.0f : 1.0f;
+        if (!result.indices.empty() && result.indices.back() == bucket) {
+            result.values.back() += value;
+        } else {
+            result.indices.push_back(bucket);
+            result.values.push_back(value);
+        }
     }
 
-    // Mapea las palabras con un índice
-    int index = 0;
-    for (const auto& word : unique_words) {
-        vocabulary_list_.push_back(word);
-        vocabulary_[word] = index++;
+    // Colisiones con signos opuestos pueden cancelarse por completo
+    size_t kept = 0;
+    for (size_t p = 0; p < result.indices.size(); ++p) {
+        if (result.values[p] == 0.0f) continue;
+        result.indices[kept] = result.indices[p];
+        result.values[kept++] = result.values[p];
     }
+    result.indices.resize(kept);
+    result.values.resize(kept);
+    return result;
+}
 
-    file.close();
+// Ordena los ids y agrupa repeticiones: Bag of words simple (cantidad),
+// para hacerlo por presencia basta usar 1.0f
+SparseVector TextLoader::to_sparse(std::vector<std::uint32_t>& ids) {
+    SparseVector result;
+    std::sort(ids.begin(), ids.end());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (!result.indices.empty() && result.indices.back() == ids[i]) {
+            result.values.back() += 1.0f;
+        } else {
+            result.indices.push_back(ids[i]);
+            result.values.push_back(1.0f);
+        }
+    }
+    return result;
 }
 
-std::vector<std::string> TextLoader::tokenize(const std::string& text) {
-    std::stringstream ss(text);
-    std::string word;
-    std::vector<std::string> tokens;
+std::vector<float> TextLoader::vectorize(std::string_view text) const {
+    std::vector<float> vector_frecuency(get_feature_size(), 0.0f);
+    auto sparse = vectorize_sparse(text);
 
-    while (ss >> word) {
-        // Normalizamos quitando signos y poniendo en minúsculas
-        word.erase(std::remove_if(word.begin(), word.end(), ispunct), word.end());
-        std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-        tokens.push_back(word);
+    for (size_t p = 0; p < sparse.indices.size(); ++p) {
+        vector_frecuency[sparse.indices[p]] = sparse.values[p];
     }
 
-    return tokens;
+    return vector_frecuency;
 }
 
-std::vector<float> TextLoader::vectorize(const std::string& text) {
-    std::vector<float> vector_frecuency(vocabulary_.size(), 0.0f);
-    auto words = tokenize(text);
-
-    for (const auto& word : words) {
-        if (vocabulary_.find(word) != vocabulary_.end()) {
-            vector_frecuency[vocabulary_[word]] += 1.0f; // Bag of words simple (cantidad) para hacerlo por presencia basta cambiarlo a = en vez de  +=
-        }
+// Buffers por hilo: tras la primera llamada solo reserva el vector resultado
+SparseVector TextLoader::vectorize_sparse(std::string_view text) const {
+    thread_local std::string scratch;
+    thread_local std::vector<std::string_view> tokens;
+    thread_local std::vector<std::uint32_t> ids;
+    tokenize(text, scratch, tokens);
+    if (hashing_) return hash_features(tokens);
+
+    ids.clear();
+    for (const auto& word : tokens) {
+        const auto id = vocabulary_.find(word);
+        if (id != Vocabulary::npos) ids.push_back(id);
     }
 
-    return vector_frecuency;
+    auto result = to_sparse(ids);
+    result.dimension = vocabulary_.size();
+    return result;
 }
 
-int TextLoader::get_label(const std::string& label_text) {
+int TextLoader::get_label(std::string_view label_text) {
     return (label_text == "spam");
 }
 
@@ -119,8 +316,37 @@ size_t TextLoader::get_vocabulary_size() const {
     return vocabulary_.size();
 }
 
+size_t TextLoader::get_feature_size() const {
+    return hashing_ ? size_t{1} << hashing_config_.bits : vocabulary_.size();
+}
+
+bool TextLoader::is_hashing() const {
+    return hashing_;
+}
+
+void TextLoader::set_num_threads(size_t threads) {
+    num_threads_ = threads ? threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+
+const Vocabulary& TextLoader::get_vocabulary() const {
+    return vocabulary_;
+}
+
+const HashingConfig& TextLoader::get_hashing_config() const {
+    return hashing_config_;
+}
 
-const std::vector<std::string>& TextLoader::get_vocabulary_list() const {
-    return vocabulary_list_;
+void TextLoader::set_vocabulary(Vocabulary vocabulary) {
+    dataset_.clear();
+    hashing_ = false;
+    vocabulary_ = std::move(vocabulary);
 }
 
+void TextLoader::set_hashing(const HashingConfig& hashing) {
+    validate(hashing);
+    dataset_.clear();
+    vocabulary_ = Vocabulary();
+    hashing_ = true;
+    hashing_config_ = hashing;
+}
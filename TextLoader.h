@@ -6,40 +6,91 @@
 #define TEXTLOADER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include "Vocabulary.h"
 
 namespace utec::data {
 
+    // Bag of words disperso: solo se guardan las palabras presentes (índices ordenados)
+    struct SparseVector {
+        size_t dimension = 0;
+        std::vector<std::uint32_t> indices;
+        std::vector<float> values;
+    };
+
+    // Hash transparente: permite buscar en el vocabulario con string_view sin crear std::string
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+    };
+
+    // Vectorizador por hashing (feature hashing): cada palabra (o n-grama) va a
+    // uno de 2^bits buckets, sin vocabulario y con ancho fijo. El signo del
+    // hash reparte las colisiones para que en promedio se cancelen
+    struct HashingConfig {
+        unsigned bits = 16;
+        unsigned max_ngram = 1;
+        bool signed_hash = true;
+    };
+
     // Definimos de lo que se estructurara una fila (o dato)
     struct TextExample {
-        std::vector<float> vectorized_text;
+        SparseVector vectorized_text;
         int label;
     };
 
+    // Registro label,message del CSV del dataset (un campo entre comillas puede
+    // tener comas y saltos de línea) que empieza en pos; lo deja en el inicio
+    // del siguiente. Devuelve false al llegar al final de data
+    bool next_csv_record(std::string_view data, size_t& pos, std::string_view& label, std::string_view& message);
+
     // Clase encargada de cargar el dataset
     class TextLoader {
     private:
         // Atributos
         std::string filename_;
         std::vector<TextExample> dataset_;
-        std::unordered_map<std::string, int> vocabulary_;
-        std::vector<std::string> vocabulary_list_;
+        Vocabulary vocabulary_;
+        bool hashing_ = false;
+        HashingConfig hashing_config_;
+        size_t num_threads_ = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+        // Bloque mínimo por hilo en load_data: por debajo no compensa repartir
+        static constexpr size_t min_chunk_bytes = 64 << 10;
 
         // Métodos internos
-        void build_vocabulary();
-        std::vector<std::string> tokenize(const std::string& text);
+        static SparseVector to_sparse(std::vector<std::uint32_t>& ids);
+        SparseVector hash_features(const std::vector<std::string_view>& tokens) const;
 
 
     public:
         TextLoader() = default;
         TextLoader(const std::string& filename);
+        TextLoader(const std::string& filename, const HashingConfig& hashing);
+        // Hilos para load_data (0 = todos los núcleos); el resultado no depende de cuántos
+        void set_num_threads(size_t threads);
         void load_data();
         const std::vector<TextExample>& get_dataset() const;
         size_t get_vocabulary_size() const;
-        int get_label(const std::string& label_text);
-        std::vector<float> vectorize(const std::string& text);
-        const std::vector<std::string>& get_vocabulary_list() const;
+        // Ancho de los vectores: tamaño del vocabulario o 2^bits en modo hashing
+        size_t get_feature_size() const;
+        bool is_hashing() const;
+        int get_label(std::string_view label_text);
+        // Solo leen el vectorizador: se pueden llamar desde varios hilos a la vez
+        std::vector<float> vectorize(std::string_view text) const;
+        SparseVector vectorize_sparse(std::string_view text) const;
+        const Vocabulary& get_vocabulary() const;
+        const HashingConfig& get_hashing_config() const;
+
+        // Restauran el vectorizador sin leer el CSV (p. ej. desde un checkpoint):
+        // los ids siguen el orden del vocabulario, igual que tras load_data()
+        void set_vocabulary(Vocabulary vocabulary);
+        void set_hashing(const HashingConfig& hashing);
     };
 
 }
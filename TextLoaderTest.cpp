@@ -24,14 +24,26 @@ void load_data() {
 void show_map_of_first_sample() {
     const auto& dataset = loader.get_dataset();
     std::cout << "Map del primer dato del dataset: ";
-    for (size_t i = 0; i < dataset[0].vectorized_text.size(); ++i) {
-        if (dataset[0].vectorized_text[i]) std::cout << loader.get_vocabulary_list()[i] << " ";
+    for (auto index : dataset[0].vectorized_text.indices) {
+        std::cout << loader.get_vocabulary()[index] << " ";
     } std::cout << "\n";
 }
 
+// modo hashing: ancho fijo, sin vocabulario
+void load_data_hashing() {
+    TextLoader hashed("training_words_esp.csv", HashingConfig{12, 2});
+    hashed.load_data();
+
+    const auto& first = hashed.get_dataset()[0].vectorized_text;
+    std::cout << "Modo hashing (2^12 buckets, bigramas): ancho " << hashed.get_feature_size()
+              << ", vocabulario " << hashed.get_vocabulary_size()
+              << ", features del primer dato " << first.indices.size() << std::endl;
+}
+
 
 int main() {
     load_data();
     show_map_of_first_sample();
+    load_data_hashing();
     return 0;
 }
@@ -0,0 +1,313 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#include "Tokenizer.h"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UTEC_TOKENIZER_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace utec::data;
+
+namespace {
+
+    enum : unsigned char { keep = 0, space = 1, punct = 2, multibyte = 3 };
+
+    // Clases de byte como en el locale "C": isspace, ispunct y el resto se
+    // conserva (incluidos los de control). Los >= 0x80 van a la ruta UTF-8
+    constexpr std::array<unsigned char, 256> byte_classes = [] {
+        std::array<unsigned char, 256> classes{};
+        for (int c = 0; c < 256; ++c) {
+            if (c >= 0x80) classes[c] = multibyte;
+            else if (c == ' ' || (c >= '\t' && c <= '\r')) classes[c] = space;
+            else if ((c >= 33 && c <= 47) || (c >= 58 && c <= 64) || (c >= 91 && c <= 96) || (c >= 123 && c <= 126))
+                classes[c] = punct;
+        }
+        return classes;
+    }();
+
+    // Escribe el texto normalizado en out y corta los tokens
+    struct Emitter {
+        char* out;
+        std::vector<std::string_view>& tokens;
+        std::size_t size = 0;
+        std::size_t begin = 0;
+
+        void put(char c) { out[size++] = c; }
+        void end_token() {
+            if (size > begin) tokens.emplace_back(out + begin, size - begin);
+            begin = size;
+        }
+    };
+
+    // Código de la secuencia UTF-8 en text[i] y su largo en len (0 si no es
+    // válida: continuación suelta, sobrelarga, truncada o surrogate)
+    char32_t decode(std::string_view text, std::size_t i, std::size_t& len) {
+        const auto lead = static_cast<unsigned char>(text[i]);
+        std::size_t n;
+        char32_t cp, min;
+        len = 0;
+        if (lead >= 0xF5) return 0;
+        if (lead >= 0xF0) { n = 4; cp = lead & 0x07; min = 0x10000; }
+        else if (lead >= 0xE0) { n = 3; cp = lead & 0x0F; min = 0x800; }
+        else if (lead >= 0xC2) { n = 2; cp = lead & 0x1F; min = 0x80; }
+        else return 0;
+        if (i + n > text.size()) return 0;
+        for (std::size_t k = 1; k < n; ++k) {
+            const auto b = static_cast<unsigned char>(text[i + k]);
+            if ((b & 0xC0) != 0x80) return 0;
+            cp = (cp << 6) | (b & 0x3F);
+        }
+        if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return 0;
+        len = n;
+        return cp;
+    }
+
+    std::size_t encode(char32_t cp, char* out) {
+        if (cp < 0x80) {
+            out[0] = static_cast<char>(cp);
+            return 1;
+        }
+        if (cp < 0x800) {
+            out[0] = static_cast<char>(0xC0 | (cp >> 6));
+            out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 2;
+        }
+        if (cp < 0x10000) {
+            out[0] = static_cast<char>(0xE0 | (cp >> 12));
+            out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 3;
+        }
+        out[0] = static_cast<char>(0xF0 | (cp >> 18));
+        out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 4;
+    }
+
+    bool is_unicode_space(char32_t cp) {
+        return cp == 0x85 || cp == 0xA0 || cp == 0x1680 || (cp >= 0x2000 && cp <= 0x200A) ||
+               cp == 0x2028 || cp == 0x2029 || cp == 0x202F || cp == 0x205F || cp == 0x3000;
+    }
+
+    // Puntuación de Latin-1 (¡ § « ¶ · » ¿), el bloque General Punctuation
+    // (comillas tipográficas, rayas, puntos suspensivos, ancho cero) y 、。〃
+    bool is_unicode_punct(char32_t cp) {
+        switch (cp) {
+            case 0xA1: case 0xA7: case 0xAB: case 0xB6: case 0xB7: case 0xBB: case 0xBF:
+                return true;
+            default:
+                return (cp >= 0x2000 && cp <= 0x206F) || (cp >= 0x3001 && cp <= 0x3003);
+        }
+    }
+
+    // Plegado simple de mayúsculas (CaseFolding.txt, estados C y S) para
+    // Latin-1, Latin Extended-A, griego y cirílico; el resto queda igual.
+    // Nunca alarga la secuencia UTF-8, así la salida cabe en la entrada
+    char32_t fold(char32_t cp) {
+        if (cp < 0xB5) return cp;
+        if (cp == 0xB5) return 0x3BC; // µ -> μ
+        if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) return cp + 0x20;
+        if (cp >= 0x100 && cp <= 0x17F) {
+            if (cp == 0x130) return 'i';  // İ: el plegado completo sería i + U+0307
+            if (cp == 0x178) return 0xFF; // Ÿ -> ÿ
+            if (cp == 0x17F) return 's';  // ſ
+            if (cp <= 0x137 || (cp >= 0x14A && cp <= 0x177)) return cp | 1;           // pares mayúscula par
+            if ((cp >= 0x139 && cp <= 0x148) || cp >= 0x179) return cp + (cp & 1);   // pares mayúscula impar
+            return cp;
+        }
+        if (cp >= 0x391 && cp <= 0x3AB && cp != 0x3A2) return cp + 0x20;
+        if (cp == 0x386) return 0x3AC;
+        if (cp >= 0x388 && cp <= 0x38A) return cp + 0x25;
+        if (cp == 0x38C) return 0x3CC;
+        if (cp == 0x38E || cp == 0x38F) return cp + 0x3F;
+        if (cp == 0x3C2) return 0x3C3; // sigma final
+        if (cp >= 0x400 && cp <= 0x40F) return cp + 0x50;
+        if (cp >= 0x410 && cp <= 0x42F) return cp + 0x20;
+        return cp;
+    }
+
+    // Un carácter desde text[i] (un byte ASCII o una secuencia UTF-8); devuelve los bytes consumidos
+    std::size_t step(std::string_view text, std::size_t i, Emitter& e) {
+        const auto c = static_cast<unsigned char>(text[i]);
+        switch (byte_classes[c]) {
+            case keep:
+                e.put(static_cast<char>(c >= 'A' && c <= 'Z' ? c + 32 : c));
+                return 1;
+            case space:
+                e.end_token();
+                return 1;
+            case punct:
+                return 1;
+            default:
+                break;
+        }
+        std::size_t len;
+        const char32_t cp = decode(text, i, len);
+        if (len == 0) {
+            e.put(text[i]);
+            return 1;
+        }
+        if (is_unicode_space(cp)) e.end_token();
+        else if (!is_unicode_punct(cp)) e.size += encode(fold(cp), e.out + e.size);
+        return len;
+    }
+
+    // Clasifica W bytes: los deja en minúsculas en lowered y marca en space y
+    // drop (un bit por byte) los espacios y la puntuación ASCII. Devuelve los
+    // bits de los bytes >= 0x80, que estas máscaras no cubren
+    using BlockFn = std::uint64_t (*)(const char* in, char* lowered, std::uint64_t& space, std::uint64_t& drop);
+
+    constexpr std::uint64_t low_bits(std::size_t n) {
+        return n >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+    }
+
+    // Emite los primeros count bytes de un bloque clasificado
+    void emit_block(const char* lowered, std::uint64_t space, std::uint64_t drop, std::size_t count, Emitter& e) {
+        space &= low_bits(count);
+        for (std::size_t j = 0; j < count;) {
+            const std::uint64_t s = space >> j;
+            if (s & 1) {
+                e.end_token();
+                j += static_cast<std::size_t>(std::countr_one(s));
+                continue;
+            }
+            // Tramo sin espacios hasta el próximo o hasta count
+            const std::size_t len = s ? static_cast<std::size_t>(std::countr_zero(s)) : count - j;
+            const std::uint64_t d = (drop >> j) & low_bits(len);
+            if (!d) {
+                std::memcpy(e.out + e.size, lowered + j, len);
+                e.size += len;
+            } else {
+                for (std::size_t k = 0; k < len; ++k)
+                    if (!((d >> k) & 1)) e.put(lowered[j + k]);
+            }
+            j += len;
+        }
+    }
+
+    // W = 0 es la ruta escalar
+    template<std::size_t W, BlockFn F>
+    void tokenize_blocks(std::string_view text, std::string& scratch, std::vector<std::string_view>& tokens) {
+        tokens.clear();
+        scratch.resize(text.size()); // la salida nunca es más larga que la entrada: no se realoca
+        Emitter e{scratch.data(), tokens};
+
+        std::size_t i = 0;
+        if constexpr (W > 0) {
+            alignas(64) char lowered[W];
+            alignas(64) char padded[W];
+            while (i < text.size()) {
+                const std::size_t rest = text.size() - i;
+                const char* in = text.data() + i;
+                if (rest < W) { // cola: se completa con espacios, que no emiten nada
+                    std::memset(padded, ' ', W);
+                    std::memcpy(padded, in, rest);
+                    in = padded;
+                }
+                std::uint64_t space, drop;
+                const std::uint64_t high = F(in, lowered, space, drop);
+                // El tramo ASCII va por SIMD; el carácter UTF-8 que lo corta, por la ruta escalar
+                const std::size_t count = high ? static_cast<std::size_t>(std::countr_zero(high)) : std::min(rest, W);
+                emit_block(lowered, space, drop, count, e);
+                i += count;
+                if (high) i += step(text, i, e);
+            }
+        } else {
+            while (i < text.size()) i += step(text, i, e);
+        }
+        e.end_token();
+        scratch.resize(e.size);
+    }
+
+#ifdef UTEC_TOKENIZER_X86
+    // Rangos [lo, hi] sin signo: (v - lo) <= (hi - lo)  <=>  min(v - lo, hi - lo) == v - lo
+
+    __attribute__((target("sse2")))
+    inline __m128i in_range_sse2(__m128i v, char lo, char hi) {
+        const __m128i x = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+        return _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(static_cast<char>(hi - lo))), x);
+    }
+
+    __attribute__((target("sse2")))
+    std::uint64_t classify_sse2(const char* in, char* lowered, std::uint64_t& space, std::uint64_t& drop) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        const __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), in_range_sse2(v, '\t', '\r'));
+        const __m128i marks = _mm_or_si128(_mm_or_si128(in_range_sse2(v, 33, 47), in_range_sse2(v, 58, 64)),
+                                           _mm_or_si128(in_range_sse2(v, 91, 96), in_range_sse2(v, 123, 126)));
+        const __m128i upper = in_range_sse2(v, 'A', 'Z');
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lowered),
+                         _mm_add_epi8(v, _mm_and_si128(upper, _mm_set1_epi8(0x20))));
+        space = static_cast<std::uint32_t>(_mm_movemask_epi8(blank));
+        drop = static_cast<std::uint32_t>(_mm_movemask_epi8(marks));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i in_range_avx2(__m256i v, char lo, char hi) {
+        const __m256i x = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8(static_cast<char>(hi - lo))), x);
+    }
+
+    __attribute__((target("avx2")))
+    std::uint64_t classify_avx2(const char* in, char* lowered, std::uint64_t& space, std::uint64_t& drop) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+        const __m256i blank = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), in_range_avx2(v, '\t', '\r'));
+        const __m256i marks = _mm256_or_si256(_mm256_or_si256(in_range_avx2(v, 33, 47), in_range_avx2(v, 58, 64)),
+                                              _mm256_or_si256(in_range_avx2(v, 91, 96), in_range_avx2(v, 123, 126)));
+        const __m256i upper = in_range_avx2(v, 'A', 'Z');
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lowered),
+                            _mm256_add_epi8(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20))));
+        space = static_cast<std::uint32_t>(_mm256_movemask_epi8(blank));
+        drop = static_cast<std::uint32_t>(_mm256_movemask_epi8(marks));
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+    }
+
+    __attribute__((target("avx512f,avx512bw")))
+    inline __mmask64 in_range_avx512(__m512i v, char lo, char hi) {
+        return _mm512_cmple_epu8_mask(_mm512_sub_epi8(v, _mm512_set1_epi8(lo)),
+                                      _mm512_set1_epi8(static_cast<char>(hi - lo)));
+    }
+
+    __attribute__((target("avx512f,avx512bw")))
+    std::uint64_t classify_avx512(const char* in, char* lowered, std::uint64_t& space, std::uint64_t& drop) {
+        const __m512i v = _mm512_loadu_si512(in);
+        space = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(' ')) | in_range_avx512(v, '\t', '\r');
+        drop = in_range_avx512(v, 33, 47) | in_range_avx512(v, 58, 64) |
+               in_range_avx512(v, 91, 96) | in_range_avx512(v, 123, 126);
+        const __mmask64 upper = in_range_avx512(v, 'A', 'Z');
+        _mm512_storeu_si512(lowered, _mm512_mask_add_epi8(v, upper, v, _mm512_set1_epi8(0x20)));
+        return _mm512_movepi8_mask(v);
+    }
+#endif
+
+    std::vector<TokenizerKernels> pick_supported() {
+        std::vector<TokenizerKernels> out;
+#ifdef UTEC_TOKENIZER_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512bw")) out.push_back({"avx512", &tokenize_blocks<64, classify_avx512>});
+        if (__builtin_cpu_supports("avx2")) out.push_back({"avx2", &tokenize_blocks<32, classify_avx2>});
+        if (__builtin_cpu_supports("sse2")) out.push_back({"sse2", &tokenize_blocks<16, classify_sse2>});
+#endif
+        out.push_back({"scalar", &tokenize_blocks<0, nullptr>});
+        return out;
+    }
+
+}
+
+const std::vector<TokenizerKernels>& utec::data::supported_tokenizers() {
+    static const std::vector<TokenizerKernels> kernels = pick_supported();
+    return kernels;
+}
+
+void utec::data::tokenize(std::string_view text, std::string& scratch, std::vector<std::string_view>& tokens) {
+    static const TokenizeKernel active = supported_tokenizers().front().tokenize;
+    active(text, scratch, tokens);
+}
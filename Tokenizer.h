@@ -0,0 +1,42 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utec::data {
+
+    // Tokenizador de mensajes: corta en espacios, descarta los signos de
+    // puntuación y pasa a minúsculas, sin depender del locale.
+    //
+    // Los tramos ASCII se clasifican y se pasan a minúsculas de a 16/32/64
+    // bytes con SIMD (ruta elegida una vez según la CPU). Un bloque con bytes
+    // >= 0x80 pasa a la ruta UTF-8: espacios y puntuación Unicode (¿ ¡ « » …,
+    // espacio duro) separan o se descartan, y las mayúsculas latinas, griegas
+    // y cirílicas se pliegan (NÚMERO, Número y número dan el mismo token). Los
+    // bytes que no forman UTF-8 válido se copian tal cual.
+    //
+    // El texto normalizado queda en scratch y tokens tiene vistas a él: sin
+    // reservas por token, y reusando los dos buffers tampoco por mensaje.
+    // Las vistas valen hasta la siguiente llamada con el mismo scratch
+    void tokenize(std::string_view text, std::string& scratch, std::vector<std::string_view>& tokens);
+
+    using TokenizeKernel = void (*)(std::string_view text, std::string& scratch, std::vector<std::string_view>& tokens);
+
+    struct TokenizerKernels {
+        const char* name;
+        TokenizeKernel tokenize;
+    };
+
+    // Rutas que soporta la CPU, la mejor primero (todas dan los mismos tokens)
+    const std::vector<TokenizerKernels>& supported_tokenizers();
+
+}
+
+#endif //TOKENIZER_H
@@ -0,0 +1,98 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "TextLoader.h"
+#include "Tokenizer.h"
+
+using namespace utec::data;
+
+// Tokenizador anterior (ispunct/tolower por byte, depende del locale) como referencia
+void ctype_tokenize(std::string_view text, std::string& scratch, std::vector<std::string_view>& tokens) {
+    tokens.clear();
+    scratch.clear();
+    scratch.reserve(text.size());
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))) ++i;
+        const size_t begin = scratch.size();
+        while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i]))) {
+            const auto c = static_cast<unsigned char>(text[i++]);
+            if (!std::ispunct(c)) scratch.push_back(static_cast<char>(std::tolower(c)));
+        }
+        if (scratch.size() > begin) tokens.emplace_back(scratch.data() + begin, scratch.size() - begin);
+    }
+}
+
+// Mensajes del CSV (solo el texto) y su total de bytes
+std::vector<std::string_view> read_messages(const std::string& data, size_t& bytes) {
+    std::vector<std::string_view> messages;
+    std::string_view label, message;
+    size_t pos = 0;
+    next_csv_record(data, pos, label, message); // cabecera
+    bytes = 0;
+    while (next_csv_record(data, pos, label, message)) {
+        messages.push_back(message);
+        bytes += message.size();
+    }
+    return messages;
+}
+
+// MB/s tokenizando todos los mensajes las veces necesarias para llenar ~0.5 s
+double throughput(TokenizeKernel tokenize, const std::vector<std::string_view>& messages, size_t bytes) {
+    std::string scratch;
+    std::vector<std::string_view> tokens;
+    size_t passes = 0;
+    volatile size_t checksum = 0; // que el compilador no descarte el trabajo
+    const auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        for (auto m : messages) {
+            tokenize(m, scratch, tokens);
+            checksum = checksum + tokens.size();
+        }
+        ++passes;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < 0.5);
+    return static_cast<double>(bytes * passes) / (1 << 20) / elapsed;
+}
+
+// Palabras distintas del dataset según el tokenizador
+size_t distinct_tokens(TokenizeKernel tokenize, const std::vector<std::string_view>& messages) {
+    std::string scratch;
+    std::vector<std::string_view> tokens;
+    std::vector<std::string> words;
+    for (auto m : messages) {
+        tokenize(m, scratch, tokens);
+        words.insert(words.end(), tokens.begin(), tokens.end());
+    }
+    std::sort(words.begin(), words.end());
+    return static_cast<size_t>(std::unique(words.begin(), words.end()) - words.begin());
+}
+
+int main() {
+    std::cout << std::fixed << std::setprecision(1);
+    for (const std::string path : {"training_words_eng.csv", "training_words_esp.csv"}) {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        const std::string data = buffer.str();
+        size_t bytes = 0;
+        const auto messages = read_messages(data, bytes);
+
+        std::cout << path << ": " << messages.size() << " mensajes, " << bytes / 1024 << " KB de texto\n";
+        std::cout << "  " << std::setw(18) << std::left << "referencia (ctype)" << std::right
+                  << std::setw(8) << throughput(&ctype_tokenize, messages, bytes) << " MB/s, "
+                  << distinct_tokens(&ctype_tokenize, messages) << " palabras distintas\n";
+        for (const auto& k : supported_tokenizers())
+            std::cout << "  " << std::setw(18) << std::left << k.name << std::right
+                      << std::setw(8) << throughput(k.tokenize, messages, bytes) << " MB/s, "
+                      << distinct_tokens(k.tokenize, messages) << " palabras distintas\n";
+    }
+    return 0;
+}
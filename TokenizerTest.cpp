@@ -0,0 +1,80 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Tokenizer.h"
+
+using namespace utec::data;
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    std::cout << (condition ? "[OK]    " : "[FALLA] ") << what << "\n";
+    if (!condition) ++failures;
+}
+
+std::vector<std::string> tokens_of(const TokenizerKernels& k, std::string_view text) {
+    std::string scratch;
+    std::vector<std::string_view> tokens;
+    k.tokenize(text, scratch, tokens);
+    return {tokens.begin(), tokens.end()};
+}
+
+struct Case {
+    std::string text;
+    std::vector<std::string> expected;
+    const char* what;
+};
+
+void fixed_cases(const TokenizerKernels& k) {
+    const Case cases[] = {
+        {"Hello, WORLD!! it's 2 a.m.", {"hello", "world", "its", "2", "am"}, "ASCII: minúsculas y sin puntuación"},
+        {"Número NÚMERO número", {"número", "número", "número"}, "UTF-8: NÚMERO, Número y número son el mismo token"},
+        {"¿Qué tal? ¡Genial!", {"qué", "tal", "genial"}, "puntuación ¿ ¡"},
+        {"«hola» — “adiós”…", {"hola", "adiós"}, "comillas, raya y puntos suspensivos"},
+        {"a b c", {"a", "b", "c"}, "espacio duro y em space separan"},
+        {"ÀÉÎÕÜ Ñ Ÿ Ł", {"àéîõü", "ñ", "ÿ", "ł"}, "Latin-1 y Latin Extended-A"},
+        {"ΣΟΦΙΑ ПРИВЕТ", {"σοφια", "привет"}, "griego y cirílico"},
+        {"\xff\xfe" "Ab \xc3", {"\xff\xfe" "ab", "\xc3"}, "UTF-8 inválido o truncado se copia tal cual"},
+        {std::string(70, 'X') + "Ñ" + std::string(70, 'x'), {std::string(70, 'x') + "ñ" + std::string(70, 'x')},
+         "token que cruza bloques SIMD"},
+        {" \t\r\n ", {}, "solo espacios"},
+        {"", {}, "texto vacío"},
+    };
+    for (const auto& c : cases) check(tokens_of(k, c.text) == c.expected, std::string(k.name) + ": " + c.what);
+}
+
+// Cada ruta igual a la escalar con textos al azar que mezclan ASCII, UTF-8
+// (válido e inválido), espacios y puntuación en cualquier posición de los bloques
+void same_as_scalar(const TokenizerKernels& k, const TokenizerKernels& scalar) {
+    const std::vector<std::string> pieces = {"a", "Z", "9", " ", "\t", ",", "!", "'", "Ñ", "ú", "É", "¿", " ",
+                                             "—", "€", "İ", "ſ", "\xff", "\xc3", "\xe2\x82"};
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<size_t> pick(0, pieces.size() - 1), length(0, 300);
+    bool same = true, views = true;
+    std::string scratch;
+    std::vector<std::string_view> tokens;
+    for (int trial = 0; trial < 2000; ++trial) {
+        std::string text;
+        for (size_t n = length(rng); text.size() < n;) text += pieces[pick(rng)];
+        k.tokenize(text, scratch, tokens);
+        for (auto token : tokens)
+            views = views && token.data() >= scratch.data() && token.data() + token.size() <= scratch.data() + scratch.size();
+        same = same && std::vector<std::string>(tokens.begin(), tokens.end()) == tokens_of(scalar, text);
+    }
+    check(same, std::string(k.name) + ": mismos tokens que la ruta escalar en 2000 textos al azar");
+    check(views, std::string(k.name) + ": los tokens son vistas a scratch");
+}
+
+int main() {
+    const auto& kernels = supported_tokenizers();
+    std::cout << "Ruta activa: " << kernels.front().name << "\n";
+    for (const auto& k : kernels) {
+        fixed_cases(k);
+        same_as_scalar(k, kernels.back());
+    }
+
+    std::cout << (failures ? "Fallaron " + std::to_string(failures) + " pruebas" : "Todas las pruebas pasaron") << "\n";
+    return failures ? 1 : 0;
+}
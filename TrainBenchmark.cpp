@@ -0,0 +1,125 @@
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <thread>
+#include <cmath>
+#include <string>
+#include "TextLoader.h"
+#include "DatasetUtils.h"
+#include "neural_network.h"
+#include "nn_dense.h"
+#include "nn_activation.h"
+#include "nn_loss.h"
+
+using namespace utec::data;
+using namespace utec::neural_network;
+using utec::algebra::allocation_stats;
+using utec::algebra::reset_allocation_stats;
+
+// Reservas que no pasan por el allocator de tensores (std::vector, std::function...):
+// el operator new sin alineación de todo el programa. El pool de tensores pide
+// memoria alineada, así que sus bloques no se cuentan dos veces
+std::atomic<size_t> other_allocations{0};
+
+void* operator new(size_t bytes) {
+    other_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+    throw std::bad_alloc();
+}
+// Fuera de línea: inlineado, GCC ve free() sobre memoria de new y avisa
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+// Misma arquitectura que AppManager, con pesos aleatorios de semilla fija: la
+// red termina en logits y se entrena con SigmoidBCEWithLogits. Con fuse, cada
+// Dense aplica su activación en el epílogo de la GEMM (AppManager siempre fusiona)
+NeuralNetwork<float> build_model(size_t input_size, bool fuse) {
+    std::mt19937 rng(7);
+    std::normal_distribution<float> dist(0.0f, 0.05f);
+    auto init_w = [&](Tensor<float, 2>& W) { for (auto it = W.begin(); it != W.end(); ++it) *it = dist(rng); };
+    auto init_b = [](Tensor<float, 2>& b) { b.fill(0.0f); };
+
+    NeuralNetwork<float> model;
+    model.add_layer(std::make_unique<Dense<float>>(input_size, 16, init_w, init_b));
+    model.add_layer(std::make_unique<ReLU<float>>());
+    model.add_layer(std::make_unique<Dense<float>>(16, 1, init_w, init_b));
+    if (fuse) model.fuse_layers();
+    return model;
+}
+
+template<typename Input>
+void run(const Input& X, const Tensor<float, 2>& Y, size_t max_threads, size_t batch_size, size_t epochs,
+         bool fuse) {
+    const size_t batches = (X.shape()[0] + batch_size - 1) / batch_size;
+    Tensor<float, 2> reference;
+    double base_time = 0;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        NeuralNetwork<float> model = build_model(X.shape()[1], fuse);
+        model.set_num_threads(threads);
+        // La primera época calienta el pool de tensores; se cuentan las reservas
+        // (servidas por el pool o por el heap) de la segunda a la penúltima. La
+        // última queda fuera: al terminar, train libera sus buffers y eso no es un batch
+        utec::algebra::AllocationStats stats;
+        size_t others = 0;
+        model.set_epoch_hook([&](size_t epoch, std::vector<size_t>&) {
+            if (epoch == 1) {
+                reset_allocation_stats();
+                other_allocations = 0;
+            }
+            if (epoch + 1 == epochs) {
+                stats = allocation_stats();
+                others = other_allocations;
+            }
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        model.train<SigmoidBCEWithLogits>(X, Y, epochs, batch_size, 0.5f);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double steady_batches = static_cast<double>(epochs > 2 ? (epochs - 2) * batches : 1);
+
+        auto scores = model.predict(X);
+        if (threads == 1) {
+            reference = scores;
+            base_time = elapsed;
+        }
+        float max_diff = 0;
+        for (size_t i = 0; i < scores.size(); ++i)
+            max_diff = std::max(max_diff, std::abs(scores.cbegin()[i] - reference.cbegin()[i]));
+
+        std::cout << std::setw(3) << threads << " hilos: " << elapsed << " s"
+                  << "  speedup " << base_time / elapsed << "x"
+                  << "  max |diff| vs 1 hilo " << max_diff
+                  << "  | " << std::setw(9) << elapsed * 1e9 / static_cast<double>(epochs * batches) << " ns/batch"
+                  << "  | reservas/batch " << static_cast<double>(stats.heap_allocations + stats.pool_hits) / steady_batches
+                  << "  heap/batch " << static_cast<double>(stats.heap_allocations) / steady_batches
+                  << "  otras/batch " << static_cast<double>(others) / steady_batches << "\n";
+    }
+}
+
+// Uso: TrainBenchmark [hilos_max] [batch] [épocas] [disperso|denso] [fusion]
+// (las reservas por batch se cuentan con 3 épocas o más)
+int main(int argc, char* argv[]) {
+    const size_t max_threads = argc > 1 ? std::stoul(argv[1]) : std::max(4u, std::thread::hardware_concurrency());
+    const size_t batch_size = argc > 2 ? std::stoul(argv[2]) : 256;
+    const size_t epochs = argc > 3 ? std::stoul(argv[3]) : 5;
+    const bool dense = argc > 4 && std::string(argv[4]) == "denso";
+    const bool fuse = argc > 5 && std::string(argv[5]) == "fusion";
+
+    TextLoader loader("training_words_eng.csv");
+    loader.load_data();
+    auto Y = DatasetUtils::labels_to_tensor(loader.get_dataset());
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Mensajes " << Y.shape()[0] << ", vocabulario " << loader.get_feature_size()
+              << ", batch " << batch_size << ", epocas " << epochs
+              << ", entrada " << (dense ? "densa" : "dispersa")
+              << (fuse ? ", activaciones fusionadas" : "") << "\n";
+
+    if (dense) run(DatasetUtils::vector_to_tensor(loader.get_dataset()), Y, max_threads, batch_size, epochs, fuse);
+    else run(DatasetUtils::vector_to_csr(loader.get_dataset()), Y, max_threads, batch_size, epochs, fuse);
+    return 0;
+}
@@ -0,0 +1,102 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#include "Vocabulary.h"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+using namespace utec::data;
+
+namespace {
+
+    std::uint64_t mix(std::uint64_t h) {
+        h ^= h >> 32;
+        h *= 0xd6e8feb86659fd93ull;
+        h ^= h >> 32;
+        return h;
+    }
+
+    // Los 1..7 bytes finales sin leer fuera de p ni llamar a memcpy de largo
+    // variable. Junto con el largo identifican esos bytes sin ambigüedad
+    std::uint64_t load_tail(const char* p, size_t n) {
+        if (n >= 4) {
+            std::uint32_t first, last;
+            std::memcpy(&first, p, 4);
+            std::memcpy(&last, p + n - 4, 4);
+            return (std::uint64_t{first} << 32) | last;
+        }
+        return (std::uint64_t{static_cast<unsigned char>(p[0])} << 16) |
+               (std::uint64_t{static_cast<unsigned char>(p[n >> 1])} << 8) |
+               static_cast<unsigned char>(p[n - 1]);
+    }
+
+    // De a 8 bytes: las palabras son cortas y casi siempre caben en una o dos vueltas
+    std::uint64_t hash_word(std::string_view word) {
+        std::uint64_t h = 0x9e3779b97f4a7c15ull ^ word.size();
+        size_t i = 0;
+        for (; i + 8 <= word.size(); i += 8) {
+            std::uint64_t v;
+            std::memcpy(&v, word.data() + i, 8);
+            h = mix(h ^ v);
+        }
+        if (i < word.size()) h = mix(h ^ load_tail(word.data() + i, word.size() - i));
+        return mix(h + 0x9e3779b97f4a7c15ull);
+    }
+
+    std::vector<std::string_view> views_of(const std::vector<std::string>& words) {
+        return {words.begin(), words.end()};
+    }
+
+}
+
+Vocabulary::Vocabulary(const std::vector<std::string>& words) : Vocabulary(views_of(words)) {}
+
+Vocabulary::Vocabulary(const std::vector<std::string_view>& words) {
+    size_t total = 0;
+    for (const auto& w : words) total += w.size();
+    if (total > std::numeric_limits<std::uint32_t>::max() || words.size() >= npos)
+        throw std::length_error("Vocabulary too large");
+
+    chars_.reserve(total);
+    offsets_.reserve(words.size() + 1);
+    for (const auto& w : words) {
+        chars_.append(w);
+        offsets_.push_back(static_cast<std::uint32_t>(chars_.size()));
+    }
+    if (words.empty()) return;
+
+    size_t capacity = 2;
+    while (capacity < 2 * words.size()) capacity *= 2;
+    slots_.assign(capacity, 0);
+    const size_t mask = capacity - 1;
+    for (std::uint32_t id = 0; id < words.size(); ++id) {
+        const std::uint64_t h = hash_word(words[id]);
+        size_t i = h & mask;
+        for (; slots_[i]; i = (i + 1) & mask) {
+            if ((slots_[i] >> 32) == (h >> 32) && (*this)[static_cast<std::uint32_t>(slots_[i]) - 1] == words[id])
+                throw std::invalid_argument("Duplicate word in vocabulary: " + std::string(words[id]));
+        }
+        slots_[i] = (h >> 32 << 32) | (id + 1);
+    }
+}
+
+std::uint32_t Vocabulary::find(std::string_view word) const {
+    if (slots_.empty()) return npos;
+    const size_t mask = slots_.size() - 1;
+    const std::uint64_t h = hash_word(word);
+    const std::uint64_t tag = h >> 32;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        const std::uint64_t slot = slots_[i];
+        if (!slot) return npos;
+        if ((slot >> 32) == tag) {
+            const auto id = static_cast<std::uint32_t>(slot) - 1;
+            if ((*this)[id] == word) return id;
+        }
+    }
+}
+
+size_t Vocabulary::memory_bytes() const {
+    return chars_.capacity() + offsets_.capacity() * sizeof(std::uint32_t) + slots_.capacity() * sizeof(std::uint64_t);
+}
@@ -0,0 +1,59 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef VOCABULARY_H
+#define VOCABULARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utec::data {
+
+    // Vocabulario congelado: se construye una vez (al terminar load_data o al
+    // leer un checkpoint) y después solo se consulta, desde varios hilos si hace falta.
+    //
+    // Todas las palabras van seguidas en un solo bloque de caracteres (la
+    // palabra i está entre offsets[i] y offsets[i + 1]) y el índice es una
+    // tabla de direccionamiento abierto con slots de 8 bytes: 32 bits altos
+    // del hash + id. Con ocupación <= 1/2 una búsqueda casi siempre se
+    // resuelve en la misma línea de caché y solo compara el texto cuando el
+    // hash coincide. find recibe string_view: buscar nunca reserva memoria
+    class Vocabulary {
+    public:
+        static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+
+        Vocabulary() = default;
+        // El id de cada palabra es su posición en words; lanza si hay repetidas
+        explicit Vocabulary(const std::vector<std::string_view>& words);
+        explicit Vocabulary(const std::vector<std::string>& words);
+
+        // Id de word, o npos si no está
+        std::uint32_t find(std::string_view word) const;
+
+        std::string_view operator[](std::uint32_t id) const {
+            return {chars_.data() + offsets_[id], offsets_[id + 1] - offsets_[id]};
+        }
+        size_t size() const { return offsets_.size() - 1; }
+        bool empty() const { return size() == 0; }
+
+        // Bytes reservados por las tres partes
+        size_t memory_bytes() const;
+
+        // Mismas palabras en el mismo orden
+        bool operator==(const Vocabulary& other) const {
+            return offsets_ == other.offsets_ && chars_ == other.chars_;
+        }
+
+    private:
+        std::string chars_;
+        std::vector<std::uint32_t> offsets_{0};
+        std::vector<std::uint64_t> slots_; // (hash >> 32) << 32 | (id + 1); 0 = libre
+    };
+
+}
+
+#endif //VOCABULARY_H
@@ -0,0 +1,133 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "TextLoader.h"
+#include "Vocabulary.h"
+
+using namespace utec::data;
+
+// Bytes vivos en el heap: cada reserva guarda su tamaño delante
+size_t live_bytes = 0;
+size_t sink = 0; // que el compilador no descarte las búsquedas
+
+void* operator new(size_t size) {
+    auto* p = static_cast<size_t*>(std::malloc(size + 16));
+    if (!p) throw std::bad_alloc();
+    *p = size;
+    live_bytes += size;
+    return reinterpret_cast<char*>(p) + 16;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    auto* p = reinterpret_cast<size_t*>(static_cast<char*>(ptr) - 16);
+    live_bytes -= *p;
+    std::free(p);
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+
+// Estructura anterior de TextLoader: mapa palabra -> id más la lista de palabras
+struct MapVocabulary {
+    std::unordered_map<std::string, int, StringHash, std::equal_to<>> map;
+    std::vector<std::string> list;
+
+    explicit MapVocabulary(const std::vector<std::string>& words) {
+        for (const auto& w : words) {
+            list.push_back(w);
+            map.emplace(list.back(), static_cast<int>(list.size() - 1));
+        }
+    }
+    std::uint32_t find(std::string_view word) const {
+        auto it = map.find(word);
+        return it == map.end() ? Vocabulary::npos : static_cast<std::uint32_t>(it->second);
+    }
+};
+
+template<typename F>
+double seconds(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ns por búsqueda recorriendo queries las veces necesarias para llenar ~0.3 s
+template<typename V>
+double ns_per_lookup(const V& vocabulary, const std::vector<std::string_view>& queries) {
+    size_t passes = 0, sum = 0;
+    double elapsed = 0;
+    do {
+        elapsed += seconds([&] {
+            for (auto q : queries) sum += vocabulary.find(q);
+        });
+        ++passes;
+    } while (elapsed < 0.3);
+    sink += sum;
+    return elapsed * 1e9 / static_cast<double>(passes * queries.size());
+}
+
+void run(const std::string& name, const std::vector<std::string>& words, const std::vector<std::string>& query_words) {
+    const size_t before = live_bytes;
+    const MapVocabulary map(words);
+    const size_t map_bytes = live_bytes - before;
+    const Vocabulary frozen = [&] {
+        const std::vector<std::string_view> views(words.begin(), words.end());
+        return Vocabulary(views);
+    }();
+    const size_t frozen_bytes = live_bytes - before - map_bytes;
+
+    const std::vector<std::string_view> queries(query_words.begin(), query_words.end());
+    bool same = true;
+    size_t hits = 0;
+    for (auto q : queries) {
+        same = same && map.find(q) == frozen.find(q);
+        hits += frozen.find(q) != Vocabulary::npos;
+    }
+
+    std::cout << name << ": " << words.size() << " palabras, " << queries.size() << " búsquedas ("
+              << 100.0 * static_cast<double>(hits) / static_cast<double>(queries.size()) << "% encontradas)\n";
+    std::cout << "  unordered_map + vector<string>: " << std::setw(6) << ns_per_lookup(map, queries) << " ns/búsqueda, "
+              << std::setw(8) << map_bytes / 1024 << " KB\n";
+    std::cout << "  Vocabulary (arena + tabla)    : " << std::setw(6) << ns_per_lookup(frozen, queries) << " ns/búsqueda, "
+              << std::setw(8) << frozen_bytes / 1024 << " KB  (reporta " << frozen.memory_bytes() / 1024 << " KB)\n";
+    std::cout << "  mismos ids: " << (same ? "si" : "NO") << "\n";
+    if (!same) std::exit(1);
+}
+
+// Uso: VocabularyBenchmark [palabras sintéticas] (por defecto 1000000)
+int main(int argc, char* argv[]) {
+    const size_t synthetic = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    std::cout << std::fixed << std::setprecision(1);
+
+    // Vocabulario real; las búsquedas son el texto de ambos datasets (el español casi no acierta)
+    TextLoader loader("training_words_eng.csv");
+    loader.load_data();
+    std::vector<std::string> words;
+    for (std::uint32_t i = 0; i < loader.get_vocabulary().size(); ++i) words.emplace_back(loader.get_vocabulary()[i]);
+    std::vector<std::string> queries;
+    for (const std::string path : {"training_words_eng.csv", "training_words_esp.csv"}) {
+        TextLoader other(path);
+        other.load_data();
+        for (const auto& example : other.get_dataset())
+            for (auto index : example.vectorized_text.indices) queries.emplace_back(other.get_vocabulary()[index]);
+    }
+    run("training_words_eng.csv", words, queries);
+
+    // Vocabulario que no cabe en caché: la diferencia está en los fallos de caché por búsqueda
+    std::mt19937_64 rng(3);
+    auto word = [](size_t i) { return std::string(1, 'w').append(std::to_string(i)); };
+    words.clear();
+    for (size_t i = 0; i < synthetic; ++i) words.push_back(word(i * 7919 % (synthetic * 2)));
+    queries.clear();
+    std::uniform_int_distribution<size_t> pick(0, synthetic * 2);
+    for (size_t i = 0; i < 2000000; ++i) queries.push_back(word(pick(rng)));
+    run("sintético", words, queries);
+    return sink == 0;
+}
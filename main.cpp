@@ -1,8 +1,29 @@
 #include <iostream>
+#include <string>
 #include "AppManager.h"
 
-int main() {
+// Uso: main                                              menú interactivo
+//      main serve [socket|-] [batch] [espera_us]         scoring con el modelo guardado
+//      main classify <entrada|-> <salida|-> [lineas|csv] [batch] [hilos]
+int main(int argc, char* argv[]) {
     utec::app::AppManager app;
+    const std::string command = argc > 1 ? argv[1] : "";
+    if (command == "serve") {
+        const std::string endpoint = argc > 2 ? argv[2] : "spam_model.sock";
+        const size_t max_batch = argc > 3 ? std::stoul(argv[3]) : 64;
+        const size_t max_delay_us = argc > 4 ? std::stoul(argv[4]) : 1000;
+        return app.serve(endpoint, max_batch, max_delay_us);
+    }
+    if (command == "classify") {
+        if (argc < 4) {
+            std::cerr << "Uso: main classify <entrada|-> <salida|-> [lineas|csv] [batch] [hilos]" << std::endl;
+            return 2;
+        }
+        const bool csv = argc > 4 && std::string(argv[4]) == "csv";
+        const size_t batch_size = argc > 5 ? std::stoul(argv[5]) : 256;
+        const size_t threads = argc > 6 ? std::stoul(argv[6]) : 0;
+        return app.classify(argv[2], argv[3], csv, batch_size, threads);
+    }
     app.show_menu();
     return 0;
 }
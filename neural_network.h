@@ -9,81 +9,359 @@
 #include "nn_interfaces.h"
 #include "nn_optimizer.h"
 #include "nn_loss.h"
+#include "thread_pool.h"
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <functional>
+#include <numeric>
+#include <span>
 
 namespace utec::neural_network {
 
     template<typename T>
     class NeuralNetwork {
-        std::vector<std::unique_ptr<ILayer<T>>> layers_;
+        using Layers = std::vector<std::unique_ptr<ILayer<T>>>;
+    public:
+        // Recibe la época y el orden de las filas para reordenarlo (permutación de índices)
+        using EpochHook = std::function<void(size_t epoch, std::vector<size_t>& order)>;
+    private:
+        // Buffers reutilizados entre batches: la salida de cada capa (viva
+        // hasta backward), dos gradientes que se alternan hacia atrás, las
+        // etiquetas de la parte del batch (réplicas) y la entrada: el batch
+        // armado por train, la parte de cada réplica o la copia de la x de
+        // forward(), que a diferencia de train no sabe cuánto vive
+        struct Workspace {
+            std::vector<Tensor<T, 2>> outputs;
+            Tensor<T, 2> grads[2];
+            Tensor<T, 2> targets;
+            Tensor<T, 2> input;
+            CsrMatrix<T> sparse_input;
+        };
+
+        // Parámetros de todas las capas en un bloque contiguo y alineado, y sus
+        // gradientes en otro con el mismo layout; cada capa trabaja con vistas
+        // a su tramo. El tramo de cada capa empieza en una línea de caché y el
+        // relleno entre tramos queda en cero (gradiente nulo, no se mueve)
+        struct Arena {
+            Tensor<T, 1> values{0};
+            Tensor<T, 1> gradients{0};
+        };
+
+        Layers layers_;
+        Arena arena_;
+        bool finalized_ = false; // arena armada: ya no se agregan capas
+        Workspace workspace_;
         Tensor<T, 2> last_output_;
+        size_t num_threads_ = 1;
+        EpochHook epoch_hook_;
+
+        // Elementos por tarea al combinar gradientes entre hilos
+        static constexpr size_t reduce_chunk = 1 << 14;
+
+        // Mini-batch de las filas [begin, begin + count): en denso una vista,
+        // sin copiar; en CSR las filas se copian a buffer, reutilizado entre batches
+        static TensorView<T> batch_rows(TensorView<T> X, size_t begin, size_t count) {
+            return X.rows(begin, count);
+        }
+        static TensorView<T> batch_rows(TensorView<T> X, size_t begin, size_t count, Tensor<T, 2>&) {
+            return batch_rows(X, begin, count);
+        }
+        static const CsrMatrix<T>& batch_rows(const CsrMatrix<T>& X, size_t begin, size_t count,
+                                              CsrMatrix<T>& buffer) {
+            X.row_slice(begin, begin + count, buffer);
+            return buffer;
+        }
+
+        // Mini-batch con las filas idx[0..count) (orden barajado): se copian solo
+        // esas filas a buffer, que se reutiliza entre batches
+        static TensorView<T> gather_rows(const Tensor<T, 2>& X, const size_t* idx, size_t count,
+                                         Tensor<T, 2>& buffer) {
+            const size_t cols = X.shape()[1];
+            buffer.reshape(count, cols);
+            const auto src = X.span();
+            auto dst = buffer.span();
+            for (size_t r = 0; r < count; ++r)
+                std::copy_n(src.begin() + idx[r] * cols, cols, dst.begin() + r * cols);
+            return buffer;
+        }
+        static const CsrMatrix<T>& gather_rows(const CsrMatrix<T>& X, const size_t* idx, size_t count,
+                                               CsrMatrix<T>& buffer) {
+            X.gather_rows(idx, count, buffer);
+            return buffer;
+        }
+
+        // Buffer del workspace para el batch de entrada, según su tipo
+        static Tensor<T, 2>& input_buffer(Workspace& ws, TensorView<T>) { return ws.input; }
+        static CsrMatrix<T>& input_buffer(Workspace& ws, const CsrMatrix<T>&) { return ws.sparse_input; }
+
+        static const Tensor<T, 2>& forward_layers(Layers& layers, Workspace& ws, TensorView<T> x) {
+            if (layers.empty()) {
+                ws.outputs.resize(1);
+                x.copy_to(ws.outputs[0]);
+                return ws.outputs[0];
+            }
+            ws.outputs.resize(layers.size());
+            layers.front()->forward_into(x, ws.outputs[0]);
+            for (size_t i = 1; i < layers.size(); ++i) {
+                layers[i]->forward_into(ws.outputs[i - 1], ws.outputs[i]);
+            }
+            return ws.outputs.back();
+        }
+
+        // La primera capa recibe la entrada dispersa, el resto trabaja en denso
+        static const Tensor<T, 2>& forward_layers(Layers& layers, Workspace& ws, const CsrMatrix<T>& x) {
+            if (layers.empty()) throw std::logic_error("Network has no layers");
+            ws.outputs.resize(layers.size());
+            layers.front()->forward_sparse_into(x, ws.outputs[0]);
+            for (size_t i = 1; i < layers.size(); ++i) {
+                layers[i]->forward_into(ws.outputs[i - 1], ws.outputs[i]);
+            }
+            return ws.outputs.back();
+        }
+
+        static void backward_layers(Layers& layers, Workspace& ws, const Tensor<T, 2>& grad) {
+            const Tensor<T, 2>* g = &grad;
+            for (size_t i = layers.size(), k = 0; i-- > 0; k ^= 1) {
+                layers[i]->backward_into(*g, ws.grads[k]);
+                g = &ws.grads[k];
+            }
+        }
+
+        // forward + pérdida + backward: deja los gradientes en las capas
+        template<template <typename> class LossType, typename Input>
+        static void compute_gradients(Layers& layers, Workspace& ws, const Input& x, const Tensor<T, 2>& y) {
+            LossType<T> loss(forward_layers(layers, ws, x), y);
+            backward_layers(layers, ws, loss.loss_gradient());
+        }
+
+        static constexpr size_t arena_alignment = 64 / sizeof(T) ? 64 / sizeof(T) : 1;
+
+        // Arma las arenas para layers y mueve ahí los parámetros de cada capa
+        static Arena make_arena(Layers& layers) {
+            std::vector<size_t> offsets;
+            size_t total = 0;
+            for (auto& layer : layers) {
+                offsets.push_back(total);
+                total += (layer->parameter_size() + arena_alignment - 1) / arena_alignment * arena_alignment;
+            }
+            Arena arena{Tensor<T, 1>(total), Tensor<T, 1>(total)};
+            for (size_t i = 0; i < layers.size(); ++i) {
+                const size_t n = layers[i]->parameter_size();
+                if (n) layers[i]->bind_parameters(arena.values.span().subspan(offsets[i], n),
+                                                  arena.gradients.span().subspan(offsets[i], n));
+            }
+            return arena;
+        }
+
+        // Paralelismo por datos: el mini-batch se reparte entre las réplicas,
+        // cada una copia los parámetros del modelo (un solo bloque) y calcula
+        // gradientes sobre su parte. Luego se combinan en la arena principal
+        // ponderando por el tamaño de cada parte (la pérdida es un promedio), en
+        // un orden fijo para que el resultado no dependa de la planificación.
+        // Todas las arenas tienen el mismo layout, así que se combinan elemento a elemento
+        template<template <typename> class LossType, typename Input>
+        void parallel_gradients(utec::parallel::ThreadPool& pool, std::vector<Layers>& replicas,
+                                std::vector<Arena>& arenas, std::vector<Workspace>& workspaces,
+                                const Input& x_batch, const Tensor<T, 2>& y_batch) {
+            const size_t count = y_batch.shape()[0];
+            const size_t shards = std::min(replicas.size(), count);
+            const auto master = arena_.values.span();
+
+            pool.parallel_for(shards, [&](size_t s) {
+                const size_t lo = count * s / shards;
+                const size_t hi = count * (s + 1) / shards;
+                std::copy(master.begin(), master.end(), arenas[s].values.begin());
+                auto& ws = workspaces[s];
+                batch_rows(y_batch, lo, hi - lo).copy_to(ws.targets);
+                const auto& x_shard = batch_rows(x_batch, lo, hi - lo, input_buffer(ws, x_batch));
+                compute_gradients<LossType>(replicas[s], ws, x_shard, ws.targets);
+            });
+
+            // Peso de cada parte: su fracción del batch
+            const auto weight = [&](size_t s) {
+                return static_cast<T>(count * (s + 1) / shards - count * s / shards) / static_cast<T>(count);
+            };
+
+            auto grad = arena_.gradients.span();
+            const size_t chunks = (grad.size() + reduce_chunk - 1) / reduce_chunk;
+            pool.parallel_for(chunks, [&](size_t c) {
+                const size_t lo = c * reduce_chunk, hi = std::min(lo + reduce_chunk, grad.size());
+                const auto g0 = arenas[0].gradients.span();
+                const T w0 = weight(0);
+                for (size_t e = lo; e < hi; ++e) grad[e] = w0 * g0[e];
+                for (size_t s = 1; s < shards; ++s) {
+                    const auto g = arenas[s].gradients.span();
+                    const T w = weight(s);
+                    for (size_t e = lo; e < hi; ++e) grad[e] += w * g[e];
+                }
+            });
+        }
+
+        // Dos buffers por hilo que se alternan entre capas (ping-pong); tras la
+        // primera llamada ya no se pide memoria salvo que crezca el batch
+        template<typename Input>
+        Tensor<T, 2> infer_layers(const Input& X) const {
+            if (layers_.empty()) throw std::logic_error("Network has no layers");
+            thread_local Tensor<T, 2> ping, pong;
+            if constexpr (std::is_same_v<Input, CsrMatrix<T>>)
+                layers_.front()->infer_sparse(X, ping);
+            else
+                layers_.front()->infer(X, ping);
+            for (size_t i = 1; i < layers_.size(); ++i) {
+                layers_[i]->infer(ping, pong);
+                std::swap(ping, pong);
+            }
+            return ping;
+        }
 
     public:
+        // Hasta finalize cada capa tiene su propia memoria; agregar capas no
+        // mueve parámetros
         void add_layer(std::unique_ptr<ILayer<T>> layer) {
+            if (finalized_) throw std::logic_error("Cannot add layers after finalize()");
             layers_.emplace_back(std::move(layer));
         }
 
-        Tensor<T, 2> forward(const Tensor<T, 2>& x) {
-            last_output_ = x;
-            for (auto& layer : layers_) {
-                last_output_ = layer->forward(last_output_);
+        // Arma las arenas una sola vez, con todas las capas: cada capa copia ahí
+        // sus parámetros y desde entonces trabaja sobre ellas. train, optimize y
+        // los accesos no const a los parámetros lo llaman solos
+        void finalize() {
+            if (finalized_) return;
+            arena_ = make_arena(layers_);
+            finalized_ = true;
+        }
+
+        // Todos los parámetros (y sus gradientes) en un bloque, con el layout de
+        // la arena. Las vistas valen mientras viva la red: la arena no se rehace
+        std::span<T> parameter_values() { finalize(); return arena_.values.span(); }
+        std::span<T> parameter_gradients() { finalize(); return arena_.gradients.span(); }
+        // Vacío si la red todavía no se finalizó (los parámetros siguen en cada capa)
+        std::span<const T> parameter_values() const { return arena_.values.span(); }
+
+        // Deja que cada capa absorba a la siguiente cuando puede (una Dense
+        // seguida de ReLU, Tanh, etc. aplica bias y activación en una pasada)
+        void fuse_layers() {
+            Layers fused;
+            for (size_t i = 0; i < layers_.size(); ++i) {
+                fused.push_back(std::move(layers_[i]));
+                while (i + 1 < layers_.size() && fused.back()->fuse(*layers_[i + 1])) ++i;
             }
+            layers_ = std::move(fused);
+            workspace_ = Workspace{};
+        }
+
+        size_t layer_count() const { return layers_.size(); }
+        const ILayer<T>& layer(size_t i) const { return *layers_.at(i); }
+
+        // Hilos para train (0 = todos los núcleos). Con más de uno cada
+        // mini-batch se reparte entre ellos (paralelismo por datos)
+        void set_num_threads(size_t threads) {
+            num_threads_ = threads ? threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        // Se llama al inicio de cada época de train para barajar el orden de las
+        // filas; el dataset no se copia, cada batch junta solo sus filas
+        void set_epoch_hook(EpochHook hook) {
+            epoch_hook_ = std::move(hook);
+        }
+
+        // Las capas guardan vistas a su entrada hasta backward: x se copia al
+        // workspace por si el llamador no la mantiene viva
+        Tensor<T, 2> forward(TensorView<T> x) {
+            x.copy_to(workspace_.input);
+            last_output_ = forward_layers(layers_, workspace_, workspace_.input);
+            return last_output_;
+        }
+
+        Tensor<T, 2> forward(const CsrMatrix<T>& x) {
+            workspace_.sparse_input = x;
+            last_output_ = forward_layers(layers_, workspace_, workspace_.sparse_input);
             return last_output_;
         }
 
         void backward(const Tensor<T, 2>& grad) {
-            Tensor<T, 2> g = grad;
-            for (int i = layers_.size() - 1; i >= 0; --i) {
-                g = layers_[i]->backward(g);
-            }
+            backward_layers(layers_, workspace_, grad);
         }
 
         void optimize(T learning_rate) {
             SGD<T> opt(learning_rate);  // Por defecto
-            for (auto& layer : layers_) {
-                layer->update_params(opt);
-            }
+            opt.attach({{parameter_values(), parameter_gradients()}});
+            opt.step();
         }
 
-        Tensor<T, 2> predict(const Tensor<T, 2>& X) {
-            return forward(X);
+        // Inferencia sin cachear activaciones; segura para llamar desde varios
+        // hilos a la vez mientras nadie entrene el mismo modelo
+        Tensor<T, 2> infer(TensorView<T> X) const {
+            return infer_layers(X);
         }
 
+        Tensor<T, 2> infer(const CsrMatrix<T>& X) const {
+            return infer_layers(X);
+        }
+
+        Tensor<T, 2> predict(TensorView<T> X) const {
+            return infer(X);
+        }
+
+        Tensor<T, 2> predict(const CsrMatrix<T>& X) const {
+            return infer(X);
+        }
+
+        // X puede ser Tensor<T,2> (denso) o CsrMatrix<T> (disperso)
         template <
             template <typename> class LossType,
-            template <typename> class OptimizerType = SGD
+            template <typename> class OptimizerType = SGD,
+            typename Input
         >
-        void train(const Tensor<T,2>& X, const Tensor<T,2>& Y,
+        void train(const Input& X, const Tensor<T,2>& Y,
                    const size_t epochs, const size_t batch_size, T learning_rate) {
             OptimizerType<T> optimizer(learning_rate);
+            optimizer.attach({{parameter_values(), parameter_gradients()}}); // un solo recorrido por paso
             const size_t n = X.shape()[0];
 
+            // Réplicas de las capas (parámetros + estado propio) para cada hilo
+            std::unique_ptr<utec::parallel::ThreadPool> pool;
+            std::vector<Layers> replicas;
+            std::vector<Arena> replica_arenas;
+            std::vector<Workspace> replica_workspaces;
+            if (num_threads_ > 1) {
+                pool = std::make_unique<utec::parallel::ThreadPool>(num_threads_);
+                replicas.resize(num_threads_);
+                replica_workspaces.resize(num_threads_);
+                for (auto& replica : replicas) {
+                    for (auto& layer : layers_) replica.push_back(layer->clone());
+                    replica_arenas.push_back(make_arena(replica));
+                }
+            }
+
+            std::vector<size_t> order(n);
+            std::iota(order.begin(), order.end(), size_t{0});
+            auto& x_buffer = input_buffer(workspace_, X);
+            Tensor<T, 2> y_buffer;
+
             for (size_t epoch = 0; epoch < epochs; ++epoch) {
+                if (epoch_hook_) epoch_hook_(epoch, order);
+
                 for (size_t i = 0; i < n; i += batch_size) {
                     size_t actual_batch_size = std::min(batch_size, n - i);
 
-                    // Crear mini-batch
-                    Tensor<T, 2> x_batch(actual_batch_size, X.shape()[1]);
-                    Tensor<T, 2> y_batch(actual_batch_size, Y.shape()[1]);
-                    for (size_t j = 0; j < actual_batch_size; ++j) {
-                        for (size_t k = 0; k < X.shape()[1]; ++k)
-                            x_batch(j, k) = X(i + j, k);
-                        for (size_t k = 0; k < Y.shape()[1]; ++k)
-                            y_batch(j, k) = Y(i + j, k);
-                    }
-
-                    Tensor<T, 2> y_pred = forward(x_batch);
-                    LossType<T> loss(y_pred, y_batch);
-                    Tensor<T, 2> dL = loss.loss_gradient();
+                    // Crear mini-batch: vista contigua o filas según el orden de la época
+                    const size_t* idx = order.data() + i;
+                    auto&& x_batch = epoch_hook_ ? gather_rows(X, idx, actual_batch_size, x_buffer)
+                                                 : batch_rows(X, i, actual_batch_size, x_buffer);
+                    if (epoch_hook_) gather_rows(Y, idx, actual_batch_size, y_buffer);
+                    else batch_rows(Y, i, actual_batch_size).copy_to(y_buffer);
 
-                    backward(dL);
-
-                    for (auto& layer : layers_)
-                        layer->update_params(optimizer);
+                    if (pool) {
+                        parallel_gradients<LossType>(*pool, replicas, replica_arenas, replica_workspaces, x_batch, y_buffer);
+                    } else {
+                        compute_gradients<LossType>(layers_, workspace_, x_batch, y_buffer);
+                    }
 
-                    optimizer.step(); // para Adam, ignorado por SGD
+                    optimizer.step();
                 }
             }
         }
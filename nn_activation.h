@@ -6,54 +6,310 @@
 #define PROG3_NN_FINAL_PROJECT_V2025_01_NN_ACTIVATION_H
 
 #include "nn_interfaces.h"
+#include "tensor_math.h"
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
 
 namespace utec::neural_network {
 
+    // Activaciones elemento a elemento. Los mismos kernels sirven a las capas
+    // de activación y a una Dense con la activación fusionada (ver ILayer::fuse)
+    enum class ActivationKind { Identity, ReLU, LeakyReLU, Sigmoid, Tanh, GELU };
+
+    template<typename T>
+    struct Activation {
+        ActivationKind kind = ActivationKind::Identity;
+        T slope = static_cast<T>(0.01); // LeakyReLU: pendiente para z <= 0
+    };
+
+    // Lo que forward guarda para backward, solo lo necesario: un bit por
+    // elemento (ReLU, LeakyReLU), la salida (Sigmoid, Tanh) o la entrada (GELU)
+    template<typename T>
+    struct ActivationState {
+        std::vector<std::uint64_t> mask;
+        std::vector<T> saved;
+        size_t size = 0;
+    };
+
+    namespace detail {
+        // GELU con la aproximación tanh: 0.5·x·(1 + tanh(√(2/π)·(x + 0.044715·x³)))
+        template<typename T>
+        constexpr T gelu_c = static_cast<T>(0.7978845608028654);
+        template<typename T>
+        constexpr T gelu_a = static_cast<T>(0.044715);
+
+        template<typename T>
+        std::vector<T>& scratch() {
+            thread_local std::vector<T> buffer;
+            return buffer;
+        }
+
+        // Los bits de la máscara se escriben desde la posición offset, que no
+        // tiene por qué caer al inicio de una palabra (tramos de la GEMM)
+        template<bool Leaky, typename T>
+        void rectify(std::span<const T> z, std::span<T> out, T slope, std::uint64_t* mask, size_t offset) {
+            const size_t n = z.size();
+            for (size_t i = 0; i < n;) {
+                const size_t bit = (offset + i) % 64;
+                const size_t m = std::min<size_t>(64 - bit, n - i);
+                std::uint64_t bits = 0;
+                for (size_t j = 0; j < m; ++j) {
+                    const T v = z[i + j];
+                    const bool pos = v > 0;
+                    bits |= static_cast<std::uint64_t>(pos) << j;
+                    out[i + j] = pos ? v : (Leaky ? v * slope : T{});
+                }
+                if (mask) mask[(offset + i) / 64] |= bits << bit;
+                i += m;
+            }
+        }
+    }
+
+    // Deja state listo para n elementos, antes de activate_range
+    template<typename T>
+    void activation_reserve(const Activation<T>& act, ActivationState<T>& state, size_t n) {
+        state.size = n;
+        switch (act.kind) {
+            case ActivationKind::ReLU:
+            case ActivationKind::LeakyReLU: state.mask.assign((n + 63) / 64, 0); break;
+            case ActivationKind::Sigmoid:
+            case ActivationKind::Tanh:
+            case ActivationKind::GELU: state.saved.resize(n); break;
+            case ActivationKind::Identity: break;
+        }
+    }
+
+    // out = f(z) sobre el tramo [offset, offset + z.size()) del total reservado
+    // en state. out puede ser el mismo arreglo que z. Así el epílogo de la GEMM
+    // activa cada bloque de la salida mientras sigue en caché
+    template<typename T>
+    void activate_range(const Activation<T>& act, std::span<const T> z, std::span<T> out,
+                        ActivationState<T>* state, size_t offset) {
+        if (z.size() != out.size()) throw std::invalid_argument("Activation input and output sizes do not match");
+        const size_t n = z.size();
+        if (state && offset + n > state->size) throw std::invalid_argument("Activation range exceeds its state");
+        switch (act.kind) {
+            case ActivationKind::Identity:
+                if (out.data() != z.data()) std::copy(z.begin(), z.end(), out.begin());
+                break;
+            case ActivationKind::ReLU:
+            case ActivationKind::LeakyReLU: {
+                std::uint64_t* mask = state ? state->mask.data() : nullptr;
+                if (act.kind == ActivationKind::ReLU) detail::rectify<false>(z, out, T{}, mask, offset);
+                else detail::rectify<true>(z, out, act.slope, mask, offset);
+                break;
+            }
+            case ActivationKind::Sigmoid:
+            case ActivationKind::Tanh:
+                if (act.kind == ActivationKind::Sigmoid) algebra::vmath::sigmoid<T>(z, out);
+                else algebra::vmath::tanh<T>(z, out);
+                if (state) std::copy(out.begin(), out.end(), state->saved.begin() + offset);
+                break;
+            case ActivationKind::GELU: {
+                // x se conserva aparte porque out puede pisar z
+                T* x = nullptr;
+                if (state) {
+                    x = state->saved.data() + offset;
+                } else {
+                    detail::scratch<T>().resize(n);
+                    x = detail::scratch<T>().data();
+                }
+                std::copy(z.begin(), z.end(), x);
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = detail::gelu_c<T> * (x[i] + detail::gelu_a<T> * x[i] * x[i] * x[i]);
+                algebra::vmath::tanh<T>(out, out);
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = static_cast<T>(0.5) * x[i] * (1 + out[i]);
+                break;
+            }
+        }
+    }
+
+    // out = f(z). out puede ser el mismo arreglo que z. Con state se guarda
+    // lo que activation_backward necesita
+    template<typename T>
+    void activate(const Activation<T>& act, std::span<const T> z, std::span<T> out,
+                  ActivationState<T>* state = nullptr) {
+        if (state) activation_reserve(act, *state, z.size());
+        activate_range(act, z, out, state, 0);
+    }
+
+    // dz = g · f'(z) con lo guardado en state. dz puede ser el mismo arreglo que g
+    template<typename T>
+    void activation_backward(const Activation<T>& act, const ActivationState<T>& state,
+                             std::span<const T> g, std::span<T> dz) {
+        const size_t n = g.size();
+        if (dz.size() != n || (act.kind != ActivationKind::Identity && state.size != n))
+            throw std::invalid_argument("Gradient does not match the last forward pass");
+        switch (act.kind) {
+            case ActivationKind::Identity:
+                if (dz.data() != g.data()) std::copy(g.begin(), g.end(), dz.begin());
+                break;
+            case ActivationKind::ReLU:
+            case ActivationKind::LeakyReLU: {
+                const T slope = act.kind == ActivationKind::ReLU ? T{} : act.slope;
+                for (size_t i = 0; i < n; ++i) {
+                    const bool pos = (state.mask[i / 64] >> (i % 64)) & 1;
+                    dz[i] = pos ? g[i] : g[i] * slope;
+                }
+                break;
+            }
+            case ActivationKind::Sigmoid: {
+                const T* s = state.saved.data();
+                for (size_t i = 0; i < n; ++i) dz[i] = g[i] * s[i] * (1 - s[i]);
+                break;
+            }
+            case ActivationKind::Tanh: {
+                const T* t = state.saved.data();
+                for (size_t i = 0; i < n; ++i) dz[i] = g[i] * (1 - t[i] * t[i]);
+                break;
+            }
+            case ActivationKind::GELU: {
+                const T* x = state.saved.data();
+                auto& t = detail::scratch<T>();
+                t.resize(n);
+                for (size_t i = 0; i < n; ++i)
+                    t[i] = detail::gelu_c<T> * (x[i] + detail::gelu_a<T> * x[i] * x[i] * x[i]);
+                algebra::vmath::tanh<T>(t, t);
+                for (size_t i = 0; i < n; ++i) {
+                    const T du = detail::gelu_c<T> * (1 + 3 * detail::gelu_a<T> * x[i] * x[i]);
+                    const T d = static_cast<T>(0.5) * (1 + t[i]) + static_cast<T>(0.5) * x[i] * (1 - t[i] * t[i]) * du;
+                    dz[i] = g[i] * d;
+                }
+                break;
+            }
+        }
+    }
+
+    // Base de las activaciones elemento a elemento: una pasada contigua por
+    // forward y otra por backward, sin copiar z salvo que f' la necesite
+    template<typename T>
+    class ElementwiseActivation : public ILayer<T> {
+        Activation<T> act_;
+        ActivationState<T> state_;
+        std::array<size_t, 2> shape_{};
+    protected:
+        explicit ElementwiseActivation(Activation<T> act) : act_(act) {}
+    public:
+        const Activation<T>& activation() const { return act_; }
+
+        void forward_into(TensorView<T> z, Tensor<T, 2>& out) override {
+            shape_ = z.shape();
+            out.reshape(shape_[0], shape_[1]);
+            activate<T>(act_, {z.data(), z.size()}, out.span(), &state_);
+        }
+
+        void infer(TensorView<T> z, Tensor<T, 2>& out) const override {
+            out.reshape(z.shape()[0], z.shape()[1]);
+            activate<T>(act_, {z.data(), z.size()}, out.span());
+        }
+
+        void backward_into(const Tensor<T, 2>& g, Tensor<T, 2>& dz) override {
+            dz.reshape(shape_[0], shape_[1]);
+            activation_backward<T>(act_, state_, g.span(), dz.span());
+        }
+    };
+
+    template<typename T>
+    class ReLU final : public ElementwiseActivation<T> {
+    public:
+        ReLU() : ElementwiseActivation<T>({ActivationKind::ReLU}) {}
+        std::unique_ptr<ILayer<T>> clone() const override {
+            return std::make_unique<ReLU<T>>(*this);
+        }
+    };
+
+    template<typename T>
+    class LeakyReLU final : public ElementwiseActivation<T> {
+    public:
+        explicit LeakyReLU(T slope = static_cast<T>(0.01))
+            : ElementwiseActivation<T>({ActivationKind::LeakyReLU, slope}) {}
+        std::unique_ptr<ILayer<T>> clone() const override {
+            return std::make_unique<LeakyReLU<T>>(*this);
+        }
+    };
+
     template<typename T>
-    class ReLU final : public ILayer<T> {
-        Tensor<T, 2> z_;
+    class Sigmoid final : public ElementwiseActivation<T> {
     public:
-        Tensor<T, 2> forward(const Tensor<T, 2>& z) override {
-            z_ = z;
-            Tensor<T, 2> result = z;
-            for (size_t i = 0; i < z.shape()[0]; ++i)
-                for (size_t j = 0; j < z.shape()[1]; ++j)
-                    result(i, j) = std::max(static_cast<T>(0), z(i, j));
-            return result;
+        Sigmoid() : ElementwiseActivation<T>({ActivationKind::Sigmoid}) {}
+        std::unique_ptr<ILayer<T>> clone() const override {
+            return std::make_unique<Sigmoid<T>>(*this);
         }
+    };
+
+    template<typename T>
+    class Tanh final : public ElementwiseActivation<T> {
+    public:
+        Tanh() : ElementwiseActivation<T>({ActivationKind::Tanh}) {}
+        std::unique_ptr<ILayer<T>> clone() const override {
+            return std::make_unique<Tanh<T>>(*this);
+        }
+    };
 
-        Tensor<T, 2> backward(const Tensor<T, 2>& g) override {
-            Tensor<T, 2> dz = g;
-            for (size_t i = 0; i < z_.shape()[0]; ++i)
-                for (size_t j = 0; j < z_.shape()[1]; ++j)
-                    dz(i, j) = z_(i, j) > 0 ? g(i, j) : 0;
-            return dz;
+    template<typename T>
+    class GELU final : public ElementwiseActivation<T> {
+    public:
+        GELU() : ElementwiseActivation<T>({ActivationKind::GELU}) {}
+        std::unique_ptr<ILayer<T>> clone() const override {
+            return std::make_unique<GELU<T>>(*this);
         }
     };
 
+    // Softmax por fila, estable: exp(z - max(z)) / suma. Guarda la salida s,
+    // con la que backward calcula dz = s · (g - Σ g·s) en cada fila
     template<typename T>
-    class Sigmoid final : public ILayer<T> {
+    class Softmax final : public ILayer<T> {
         Tensor<T, 2> s_;
     public:
-        Tensor<T, 2> forward(const Tensor<T, 2>& z) override {
-            s_ = z;
-            for (size_t i = 0; i < z.shape()[0]; ++i)
-                for (size_t j = 0; j < z.shape()[1]; ++j)
-                    s_(i, j) = static_cast<T>(1) / (static_cast<T>(1) + std::exp(-z(i, j)));
-            return s_;
+        void forward_into(TensorView<T> z, Tensor<T, 2>& out) override {
+            infer(z, out);
+            TensorView<T>(out).copy_to(s_);
+        }
+
+        void infer(TensorView<T> z, Tensor<T, 2>& out) const override {
+            const auto [rows, cols] = z.shape();
+            out.reshape(rows, cols);
+            auto o = out.span();
+            for (size_t r = 0; r < rows; ++r) {
+                const auto in = z.row(r);
+                const auto row = o.subspan(r * cols, cols);
+                const T m = cols ? *std::max_element(in.begin(), in.end()) : T{};
+                for (size_t j = 0; j < cols; ++j) row[j] = in[j] - m;
+                algebra::vmath::exp<T>(row, row);
+                T sum = 0;
+                for (size_t j = 0; j < cols; ++j) sum += row[j];
+                const T inv = 1 / sum;
+                for (size_t j = 0; j < cols; ++j) row[j] *= inv;
+            }
         }
 
-        Tensor<T, 2> backward(const Tensor<T, 2>& g) override {
-            Tensor<T, 2> dz = g;
-            for (size_t i = 0; i < s_.shape()[0]; ++i)
-                for (size_t j = 0; j < s_.shape()[1]; ++j)
-                    dz(i, j) = g(i, j) * s_(i, j) * (1 - s_(i, j));
-            return dz;
+        void backward_into(const Tensor<T, 2>& g, Tensor<T, 2>& dz) override {
+            const auto [rows, cols] = s_.shape();
+            if (g.shape() != s_.shape()) throw std::invalid_argument("Gradient does not match the last forward pass");
+            dz.reshape(rows, cols);
+            const auto s = s_.cbegin();
+            const auto in = g.cbegin();
+            auto d = dz.begin();
+            for (size_t r = 0; r < rows; ++r) {
+                const size_t base = r * cols;
+                T dot = 0;
+                for (size_t j = 0; j < cols; ++j) dot += in[base + j] * s[base + j];
+                for (size_t j = 0; j < cols; ++j) d[base + j] = s[base + j] * (in[base + j] - dot);
+            }
+        }
+
+        std::unique_ptr<ILayer<T>> clone() const override {
+            return std::make_unique<Softmax<T>>(*this);
         }
     };
 
 }
 
 #endif // PROG3_NN_FINAL_PROJECT_V2025_01_NN_ACTIVATION_H
-
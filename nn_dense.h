@@ -7,73 +7,275 @@
 
 
 #include "nn_interfaces.h"
+#include "nn_activation.h"
+#include <algorithm>
 #include <functional>
+#include <memory>
+#include <stdexcept>
 
 namespace utec::neural_network {
 
     template<typename T>
     class Dense final : public ILayer<T> {
-        Tensor<T, 2> W_, dW_;
-        Tensor<T, 1> b_, db_;
-        Tensor<T, 2> last_input_;
+        size_t in_f_, out_f_;
+        // Memoria propia [W | b] y [dW | db] mientras la capa no esté en las
+        // arenas de una red; después quedan vacías
+        Tensor<T, 1> own_values_, own_grads_;
+        // Vistas a los parámetros, en la memoria propia o en las arenas
+        std::span<T> W_, b_, dW_, db_;
+        // Entrada del último forward, sin copiarla: quien llama la mantiene
+        // viva hasta backward_into (la red guarda el batch y las salidas de
+        // cada capa en su workspace hasta entonces)
+        TensorView<T> last_input_;
+        const CsrMatrix<T>* last_sparse_input_ = nullptr;
+        bool sparse_input_ = false;
+        // Fuera de estas filas dW está en cero: las que escribió la última
+        // backward dispersa, o todas (full_grad_) si la última fue densa
+        typename CsrMatrix<T>::template Storage<std::uint32_t> grad_rows_;
+        bool full_grad_ = false;
+        // Activación fusionada (Identity si no hay): se aplica en el epílogo de
+        // la GEMM, y su derivada antes de las GEMM de backward (en d_pre_)
+        Activation<T> activation_;
+        ActivationState<T> act_state_;
+        Tensor<T, 2> d_pre_;
+
+        TensorView<T> weights_view() const { return {W_.data(), in_f_, out_f_}; }
+
+        // Deja dW en cero antes de una backward dispersa, tocando solo lo que
+        // escribió la anterior
+        void clear_grad_rows() {
+            if (full_grad_) std::fill(dW_.begin(), dW_.end(), T{});
+            else for (const auto row : grad_rows_) std::fill_n(dW_.begin() + row * out_f_, out_f_, T{});
+            grad_rows_.clear();
+            full_grad_ = false;
+        }
+
+        void point_to(std::span<T> values, std::span<T> gradients) {
+            const size_t w = in_f_ * out_f_;
+            W_ = values.first(w);
+            b_ = values.subspan(w, out_f_);
+            dW_ = gradients.first(w);
+            db_ = gradients.subspan(w, out_f_);
+        }
+
+        // Lo que el epílogo necesita para activar cada tramo terminado de la salida
+        struct FusedOutput {
+            const Activation<T>* activation;
+            ActivationState<T>* state;
+        };
+
+        static void activate_strip(void* ctx, T* c, size_t ldc, size_t row, size_t col, size_t m, size_t n) {
+            const auto& fused = *static_cast<const FusedOutput*>(ctx);
+            if (n == ldc) { // filas completas: un solo tramo contiguo
+                activate_range<T>(*fused.activation, {c, m * n}, {c, m * n}, fused.state, row * ldc);
+                return;
+            }
+            for (size_t r = 0; r < m; ++r) {
+                T* p = c + r * ldc;
+                activate_range<T>(*fused.activation, {p, n}, {p, n}, fused.state, (row + r) * ldc + col);
+            }
+        }
+
+        // bias se suma en registros al guardar cada tile; la activación, sobre
+        // cada tramo recién escrito. Así la salida se recorre una sola vez
+        algebra::gemm::Epilogue<T> epilogue(FusedOutput& fused) const {
+            algebra::gemm::Epilogue<T> result{b_.data()};
+            if (activation_.kind != ActivationKind::Identity) {
+                result.finish = &activate_strip;
+                result.ctx = &fused;
+            }
+            return result;
+        }
+
+        FusedOutput prepare_state(size_t batch_size) {
+            if (activation_.kind != ActivationKind::Identity)
+                activation_reserve(activation_, act_state_, batch_size * out_f_);
+            return {&activation_, &act_state_};
+        }
 
     public:
         // Constructor genérico con funciones de inicialización
         template<typename InitWFun, typename InitBFun>
         Dense(size_t in_f, size_t out_f, InitWFun init_w_fun, InitBFun init_b_fun)
-                : W_(in_f, out_f), dW_(in_f, out_f),
-                  b_(out_f), db_(out_f) {
-            init_w_fun(W_);
-            // Adaptar b_ como Tensor<T,2> para que init_b_fun pueda usarlo
-            Tensor<T, 2> b_as_2d(1, out_f);
-            for (size_t j = 0; j < out_f; ++j)
-                b_as_2d(0, j) = b_(j);
-            init_b_fun(b_as_2d);
-            for (size_t j = 0; j < out_f; ++j)
-                b_(j) = b_as_2d(0, j);
-        }
-
-        Tensor<T, 2> forward(const Tensor<T, 2>& x) override {
+                : in_f_(in_f), out_f_(out_f),
+                  own_values_(in_f * out_f + out_f), own_grads_(in_f * out_f + out_f) {
+            point_to(own_values_.span(), own_grads_.span());
+            Tensor<T, 2> W(in_f, out_f);
+            init_w_fun(W);
+            std::copy(W.cbegin(), W.cend(), W_.begin());
+            // b se pasa como Tensor<T,2> (1 x out_f) para que init_b_fun pueda usarlo
+            Tensor<T, 2> b(1, out_f);
+            init_b_fun(b);
+            std::copy(b.cbegin(), b.cend(), b_.begin());
+        }
+
+        // La copia siempre tiene memoria propia, aunque el original esté en una arena
+        Dense(const Dense& other)
+                : in_f_(other.in_f_), out_f_(other.out_f_),
+                  own_values_(other.parameter_size()), own_grads_(other.parameter_size()),
+                  last_input_(other.last_input_), last_sparse_input_(other.last_sparse_input_),
+                  sparse_input_(other.sparse_input_), grad_rows_(other.grad_rows_),
+                  full_grad_(other.full_grad_), activation_(other.activation_),
+                  act_state_(other.act_state_), d_pre_(other.d_pre_) {
+            point_to(own_values_.span(), own_grads_.span());
+            std::copy(other.W_.begin(), other.W_.end(), W_.begin());
+            std::copy(other.b_.begin(), other.b_.end(), b_.begin());
+            std::copy(other.dW_.begin(), other.dW_.end(), dW_.begin());
+            std::copy(other.db_.begin(), other.db_.end(), db_.begin());
+        }
+        Dense& operator=(const Dense&) = delete;
+
+        void forward_into(TensorView<T> x, Tensor<T, 2>& output) override {
+            sparse_input_ = false;
             last_input_ = x;
-            auto output = matrix_product(x, W_); // (batch_size × out_features)
-            const size_t batch_size = x.shape()[0];
-            for (size_t i = 0; i < batch_size; ++i)
-                for (size_t j = 0; j < b_.shape()[0]; ++j)
-                    output(i, j) += b_(j);
-            return output;
+            auto fused = prepare_state(x.shape()[0]);
+            matrix_product(x, weights_view(), output, epilogue(fused)); // (batch_size × out_features)
         }
 
-        Tensor<T, 2> backward(const Tensor<T, 2>& dZ) override {
-            // dW = Xᵗ * dZ
-            dW_ = matrix_product(transpose_2d(last_input_), dZ);
+        // Solo se recorren las filas de W que corresponden a columnas no nulas de x
+        void forward_sparse_into(const CsrMatrix<T>& x, Tensor<T, 2>& output) override {
+            sparse_input_ = true;
+            last_sparse_input_ = &x;
+            auto fused = prepare_state(x.shape()[0]);
+            sparse_dense_product(x, weights_view(), output, epilogue(fused));
+        }
 
-            // db = sum over batch
-            db_.fill(0);
-            const size_t batch_size = dZ.shape()[0];
-            const size_t out_features = dZ.shape()[1];
-            for (size_t j = 0; j < out_features; ++j) {
-                for (size_t i = 0; i < batch_size; ++i) {
-                    db_(j) += dZ(i, j);
-                }
-            }
+        void infer(TensorView<T> x, Tensor<T, 2>& out) const override {
+            FusedOutput fused{&activation_, nullptr};
+            matrix_product(x, weights_view(), out, epilogue(fused));
+        }
 
-            // dX = dZ * Wᵗ
-            return matrix_product(dZ, transpose_2d(W_));
+        void infer_sparse(const CsrMatrix<T>& x, Tensor<T, 2>& out) const override {
+            FusedOutput fused{&activation_, nullptr};
+            sparse_dense_product(x, weights_view(), out, epilogue(fused));
         }
 
-        void update_params(IOptimizer<T>& optimizer) override {
-            optimizer.update(W_, dW_);
-            Tensor<T, 2> b2d(1, db_.shape()[0]);
-            Tensor<T, 2> db2d(1, db_.shape()[0]);
-            for (size_t j = 0; j < db_.shape()[0]; ++j) {
-                b2d(0, j) = b_(j);
-                db2d(0, j) = db_(j);
+        // dW y db se escriben sobre sus vistas y dX sobre el buffer recibido.
+        // Las traspuestas no se copian: matmul_tn / matmul_nt leen X y W en su layout
+        void backward_into(const Tensor<T, 2>& grad, Tensor<T, 2>& dX) override {
+            if (&grad == &dX) throw std::invalid_argument("Output tensor must not alias an operand");
+            // Con activación fusionada, dZ = grad · f'(z) antes de las GEMM
+            const Tensor<T, 2>* pre = &grad;
+            if (activation_.kind != ActivationKind::Identity) {
+                d_pre_.reshape(grad.shape()[0], grad.shape()[1]);
+                activation_backward<T>(activation_, act_state_, grad.span(), d_pre_.span());
+                pre = &d_pre_;
             }
-            optimizer.update(b2d, db2d);
-            for (size_t j = 0; j < db_.shape()[0]; ++j) {
-                b_(j) = b2d(0, j);
+            const Tensor<T, 2>& dZ = *pre;
+            const size_t batch_size = dZ.shape()[0];
+
+            // dW = Xᵗ * dZ. Con entrada dispersa solo cambian las filas de las
+            // columnas presentes en el batch (y las del batch anterior, que se limpian)
+            if (sparse_input_) {
+                clear_grad_rows();
+                sparse_transpose_product<T>(*last_sparse_input_, dZ, dW_);
+                const auto& rows = last_sparse_input_->col_idx();
+                grad_rows_.assign(rows.begin(), rows.end());
+            } else {
+                matmul_tn<T>(last_input_, dZ, dW_);
+                full_grad_ = true;
             }
+
+            // db = suma de dZ sobre el batch
+            std::fill(db_.begin(), db_.end(), T{});
+            const auto g = dZ.cbegin();
+            for (size_t i = 0; i < batch_size; ++i)
+                for (size_t j = 0; j < out_f_; ++j)
+                    db_[j] += g[i * out_f_ + j];
+
+            // dX = dZ * Wᵗ. Una entrada dispersa es la entrada de la red: no tiene gradiente
+            if (sparse_input_) {
+                dX.reshape(batch_size, 0);
+                return;
+            }
+            matmul_nt<T>(dZ, weights_view(), dX);
         }
+
+        void parameters(std::vector<Parameter<T>>& out) override {
+            out.push_back({W_, dW_});
+            out.push_back({b_, db_});
+        }
+
+        // Toma la activación elemento a elemento que sigue a esta capa
+        bool fuse(const ILayer<T>& next) override {
+            if (activation_.kind != ActivationKind::Identity) return false;
+            const auto* act = dynamic_cast<const ElementwiseActivation<T>*>(&next);
+            if (!act) return false;
+            activation_ = act->activation();
+            return true;
+        }
+
+        void set_activation(const Activation<T>& activation) { activation_ = activation; }
+        const Activation<T>& activation() const { return activation_; }
+
+        size_t parameter_size() const override { return in_f_ * out_f_ + out_f_; }
+
+        void bind_parameters(std::span<T> values, std::span<T> gradients) override {
+            if (values.size() != parameter_size() || gradients.size() != parameter_size())
+                throw std::invalid_argument("Parameter buffers do not match the layer size");
+            std::copy(W_.begin(), W_.end(), values.begin());
+            std::copy(b_.begin(), b_.end(), values.begin() + W_.size());
+            std::copy(dW_.begin(), dW_.end(), gradients.begin());
+            std::copy(db_.begin(), db_.end(), gradients.begin() + dW_.size());
+            point_to(values, gradients);
+            own_values_ = Tensor<T, 1>(0);
+            own_grads_ = Tensor<T, 1>(0);
+        }
+
+        std::unique_ptr<ILayer<T>> clone() const override {
+            return std::make_unique<Dense<T>>(*this);
+        }
+
+        size_t in_features() const { return in_f_; }
+        size_t out_features() const { return out_f_; }
+        std::span<const T> weights() const { return W_; }
+        std::span<const T> bias() const { return b_; }
+
+    };
+
+
+    // Dense de solo lectura cuyos pesos viven en memoria externa (un checkpoint
+    // proyectado con mmap): no copia W ni b, así varios procesos comparten las
+    // mismas páginas. owner mantiene viva esa memoria. Solo sirve para inferencia
+    template<typename T>
+    class MappedDense final : public ILayer<T> {
+        const T* W_;
+        const T* b_;
+        size_t in_f_, out_f_;
+        std::shared_ptr<const void> owner_;
+
+    public:
+        MappedDense(const T* weights, const T* bias, size_t in_f, size_t out_f, std::shared_ptr<const void> owner)
+            : W_(weights), b_(bias), in_f_(in_f), out_f_(out_f), owner_(std::move(owner)) {}
+
+        void forward_into(TensorView<T> x, Tensor<T, 2>& output) override {
+            infer(x, output);
+        }
+
+        void forward_sparse_into(const CsrMatrix<T>& x, Tensor<T, 2>& output) override {
+            infer_sparse(x, output);
+        }
+
+        void infer(TensorView<T> x, Tensor<T, 2>& out) const override {
+            matrix_product(x, TensorView<T>(W_, in_f_, out_f_), out, algebra::gemm::Epilogue<T>{b_});
+        }
+
+        void infer_sparse(const CsrMatrix<T>& x, Tensor<T, 2>& out) const override {
+            sparse_dense_product(x, TensorView<T>(W_, in_f_, out_f_), out, algebra::gemm::Epilogue<T>{b_});
+        }
+
+        void backward_into(const Tensor<T, 2>&, Tensor<T, 2>&) override {
+            throw std::logic_error("MappedDense is read-only: load the checkpoint as trainable to train it");
+        }
+
+        std::unique_ptr<ILayer<T>> clone() const override {
+            return std::make_unique<MappedDense<T>>(*this);
+        }
+
+        size_t in_features() const { return in_f_; }
+        size_t out_features() const { return out_f_; }
+        std::span<const T> weights() const { return {W_, in_f_ * out_f_}; }
+        std::span<const T> bias() const { return {b_, out_f_}; }
     };
 
 }
@@ -6,29 +6,100 @@
 #define PROG3_NN_FINAL_PROJECT_V2025_01_LAYER_H
 
 #include "tensor.h"
+#include "tensor_sparse.h"
+#include "tensor_view.h"
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
 
 namespace utec::neural_network {
     template<typename T, size_t DIMS>
     using Tensor = utec::algebra::Tensor<T, DIMS>;
+    template<typename T>
+    using CsrMatrix = utec::algebra::CsrMatrix<T>;
+    template<typename T>
+    using TensorView = utec::algebra::TensorView<T>;
+
+    // Parámetro entrenable: sus valores y el gradiente correspondiente (mismo tamaño)
+    template<typename T>
+    struct Parameter {
+        std::span<T> value;
+        std::span<T> gradient;
+    };
 
     // Interfaz del optimizador (SGD o Adam)
     template<typename T>
     struct IOptimizer {
         virtual ~IOptimizer() = default;
-        virtual void update(Tensor<T,2>& params, const Tensor<T,2>& gradients) = 0;
-        virtual void step() {}
+        // Registra una sola vez los parámetros de la red: el id de cada uno es
+        // su posición en params y el estado del optimizador (momentos de Adam)
+        // se reserva aquí en un buffer plano. Volver a registrar reinicia el estado.
+        // Los buffers deben seguir vivos (y en el mismo lugar) mientras se use
+        virtual void attach(std::vector<Parameter<T>> params) = 0;
+        // Un paso de optimización sobre todos los parámetros registrados,
+        // con los gradientes que tengan en ese momento
+        virtual void step() = 0;
     };
 
     // Interfaz de las capas (Dense y los diferentes tipos de activación)
     template<typename T>
     struct ILayer {
         virtual ~ILayer() = default;
-        virtual Tensor<T,2> forward(const Tensor<T,2>& x) = 0;
-        virtual Tensor<T,2> backward(const Tensor<T,2>& gradients) = 0;
+        // x es una vista: un Tensor<T,2> se convierte solo y un mini-batch no se copia.
+        // Las versiones _into escriben en out (o dx), que se redimensiona
+        // reutilizando su memoria: con buffers fijos entre batches no se pide
+        // memoria nueva. out no debe ser la misma memoria que la entrada
+        virtual void forward_into(TensorView<T> x, Tensor<T,2>& out) = 0;
+        virtual void backward_into(const Tensor<T,2>& gradients, Tensor<T,2>& dx) = 0;
+
+        // Entrada dispersa (CSR), solo para la primera capa de la red.
+        // Las capas que no la soportan lanzan excepción
+        virtual void forward_sparse_into(const CsrMatrix<T>& /*x*/, Tensor<T,2>& /*out*/) {
+            throw std::invalid_argument("Layer does not support sparse input");
+        }
+
+        Tensor<T,2> forward(TensorView<T> x) {
+            Tensor<T,2> out;
+            forward_into(x, out);
+            return out;
+        }
+        Tensor<T,2> forward_sparse(const CsrMatrix<T>& x) {
+            Tensor<T,2> out;
+            forward_sparse_into(x, out);
+            return out;
+        }
+        Tensor<T,2> backward(const Tensor<T,2>& gradients) {
+            Tensor<T,2> dx;
+            backward_into(gradients, dx);
+            return dx;
+        }
+
+        // Solo inferencia: escribe la salida en out (reutilizando su memoria) sin
+        // guardar nada para backward. Es const, varios hilos pueden usar la misma capa
+        virtual void infer(TensorView<T> x, Tensor<T,2>& out) const = 0;
+        virtual void infer_sparse(const CsrMatrix<T>& /*x*/, Tensor<T,2>& /*out*/) const {
+            throw std::invalid_argument("Layer does not support sparse input");
+        }
+
+        // Agrega a out los parámetros de la capa (las activaciones no tienen)
+        virtual void parameters(std::vector<Parameter<T>>& /*out*/) {}
+
+        // Cantidad de escalares entrenables de la capa (0 en las activaciones)
+        virtual size_t parameter_size() const { return 0; }
+
+        // Mueve los parámetros y sus gradientes a memoria externa (las arenas
+        // de la red), ambos de parameter_size() elementos: copia los valores
+        // actuales y desde ahí la capa trabaja con vistas a esa memoria
+        virtual void bind_parameters(std::span<T> /*values*/, std::span<T> /*gradients*/) {}
+
+        // Absorbe la capa siguiente (p. ej. una Dense toma la activación que
+        // la sigue y la aplica en su misma pasada). Devuelve true si lo hizo:
+        // la red quita entonces esa capa
+        virtual bool fuse(const ILayer<T>& /*next*/) { return false; }
 
-        // Se utiliza para actualizar los parameters a través el optimizador
-        // Se puede llamar tanto el método update y step si es requerido
-        virtual void update_params(IOptimizer<T>& optimizer) {}
+        // Copia independiente (parámetros y estado), para entrenar en paralelo
+        virtual std::unique_ptr<ILayer<T>> clone() const = 0;
     };
 
     // Interfaz de las perdidas (MSE o BCE)
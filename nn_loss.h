@@ -7,6 +7,7 @@
 
 
 #include "nn_interfaces.h"
+#include "tensor_math.h"
 #include <cmath>
 #include <algorithm>
 
@@ -31,8 +32,8 @@ namespace utec::neural_network {
         }
 
         Tensor<T, 2> loss_gradient() const override {
-            Tensor<T, 2> grad = y_pred_ - y_true_;
-            return grad * (static_cast<T>(2) / static_cast<T>(y_pred_.size()));
+            // Una sola pasada y una sola reserva: la resta y la escala se fusionan
+            return (y_pred_ - y_true_) * (static_cast<T>(2) / static_cast<T>(y_pred_.size()));
         }
     };
 
@@ -45,14 +46,22 @@ namespace utec::neural_network {
         BCELoss(const Tensor<T, 2>& y_predicted, const Tensor<T, 2>& y_true)
             : y_pred_(y_predicted), y_true_(y_true) {}
 
+        // Los dos logaritmos se calculan vectorizados en un solo bloque [log p | log(1-p)]
         T loss() const override {
-            T sum = 0;
-            auto total = y_pred_.size();
+            const auto total = y_pred_.size();
+            Tensor<T, 1> logs(2 * total); // del pool de tensores, como el resto del batch
+            const auto pred = y_pred_.cbegin();
             for (size_t i = 0; i < total; ++i) {
-                T y = y_true_.cbegin()[i];
-                T p = std::clamp(y_pred_.cbegin()[i], epsilon, 1 - epsilon);
-                sum += - (y * std::log(p) + (1 - y) * std::log(1 - p));
+                const T p = std::clamp(pred[i], epsilon, 1 - epsilon);
+                logs.begin()[i] = p;
+                logs.begin()[total + i] = 1 - p;
             }
+            algebra::vmath::log<T>(logs.span(), logs.span());
+            T sum = 0;
+            const auto y = y_true_.cbegin();
+            const auto l = logs.cbegin();
+            for (size_t i = 0; i < total; ++i)
+                sum += - (y[i] * l[i] + (1 - y[i]) * l[total + i]);
             return sum / static_cast<T>(total);
         }
 
@@ -68,6 +77,48 @@ namespace utec::neural_network {
         }
     };
 
+    // Sigmoid + BCE fusionados: recibe logits z (la red termina en Dense, sin
+    // Sigmoid). Pérdida estable: max(z,0) - z*y + log(1 + e^-|z|), y el
+    // gradiente respecto a z se reduce a (sigmoid(z) - y) / N en una sola pasada
+    template<typename T>
+    class SigmoidBCEWithLogits final : public ILoss<T, 2> {
+        Tensor<T, 2> logits_;
+        Tensor<T, 2> y_true_;
+    public:
+        SigmoidBCEWithLogits(const Tensor<T, 2>& logits, const Tensor<T, 2>& y_true)
+            : logits_(logits), y_true_(y_true) {}
+
+        T loss() const override {
+            const auto total = logits_.size();
+            const auto z = logits_.cbegin();
+            const auto y = y_true_.cbegin();
+            // log(1 + e^-|z|): e^-|z| en (0, 1], exp y log vectorizados sobre el mismo buffer
+            Tensor<T, 1> scratch(total); // del pool de tensores, como el resto del batch
+            const auto t = scratch.span();
+            for (size_t i = 0; i < total; ++i) t[i] = -std::abs(z[i]);
+            algebra::vmath::exp<T>(t, t);
+            for (auto& v : t) v += 1;
+            algebra::vmath::log<T>(t, t);
+            T sum = 0;
+            for (size_t i = 0; i < total; ++i)
+                sum += std::max(z[i], static_cast<T>(0)) - z[i] * y[i] + t[i];
+            return sum / static_cast<T>(total);
+        }
+
+        Tensor<T, 2> loss_gradient() const override {
+            Tensor<T, 2> grad(logits_.shape()[0], logits_.shape()[1]);
+            const auto total = logits_.size();
+            const T inv_n = static_cast<T>(1) / static_cast<T>(total);
+            // sigmoid(z) vectorizada (estable en ambos signos), luego (s - y) / N
+            algebra::vmath::sigmoid<T>(logits_.span(), grad.span());
+            const auto y = y_true_.cbegin();
+            auto g = grad.begin();
+            for (size_t i = 0; i < total; ++i)
+                g[i] = (g[i] - y[i]) * inv_n;
+            return grad;
+        }
+    };
+
 }
 
 
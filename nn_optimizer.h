@@ -8,7 +8,7 @@
 
 #include "nn_interfaces.h"
 #include <cmath>
-#include <unordered_map>
+#include <vector>
 
 namespace utec::neural_network {
 
@@ -16,12 +16,20 @@ namespace utec::neural_network {
     template<typename T>
     class SGD final : public IOptimizer<T> {
         T lr_;
+        std::vector<Parameter<T>> params_;
     public:
         explicit SGD(T learning_rate = 0.01) : lr_(learning_rate) {}
 
-        void update(Tensor<T, 2>& params, const Tensor<T, 2>& grads) override {
-            for (size_t i = 0; i < params.size(); ++i) {
-                params.begin()[i] -= lr_ * grads.cbegin()[i];
+        void attach(std::vector<Parameter<T>> params) override {
+            params_ = std::move(params);
+        }
+
+        void step() override {
+            for (const auto& p : params_) {
+                T* __restrict w = p.value.data();
+                const T* __restrict g = p.gradient.data();
+                const size_t n = p.value.size();
+                for (size_t i = 0; i < n; ++i) w[i] -= lr_ * g[i];
             }
         }
     };
@@ -35,44 +43,45 @@ namespace utec::neural_network {
         T epsilon_;
         size_t t_ = 0;
 
-        // Almacenan momentos para cada tensor
-        std::unordered_map<void*, Tensor<T, 2>> m_;
-        std::unordered_map<void*, Tensor<T, 2>> v_;
-
-        Tensor<T, 2>& get_or_init(std::unordered_map<void*, Tensor<T, 2>>& map, Tensor<T, 2>& ref) {
-            void* key = static_cast<void*>(&ref);
-            if (!map.count(key)) {
-                map[key] = Tensor<T, 2>(ref.shape()[0], ref.shape()[1]);
-                map[key].fill(0.0);
-            }
-            return map[key];
-        }
+        // Momentos de todos los parámetros en dos buffers planos: el parámetro
+        // con id p ocupa [offsets_[p], offsets_[p + 1])
+        std::vector<Parameter<T>> params_;
+        std::vector<size_t> offsets_;
+        std::vector<T> m_;
+        std::vector<T> v_;
 
     public:
         explicit Adam(T learning_rate = 0.001, T beta1 = 0.9, T beta2 = 0.999, T epsilon = 1e-8)
             : lr_(learning_rate), beta1_(beta1), beta2_(beta2), epsilon_(epsilon) {}
 
-        void step() override {
-            ++t_;
+        void attach(std::vector<Parameter<T>> params) override {
+            params_ = std::move(params);
+            offsets_.assign(1, 0);
+            for (const auto& p : params_) offsets_.push_back(offsets_.back() + p.value.size());
+            m_.assign(offsets_.back(), T{});
+            v_.assign(offsets_.back(), T{});
+            t_ = 0;
         }
 
-        void update(Tensor<T, 2>& params, const Tensor<T, 2>& grads) override {
+        void step() override {
             ++t_;
-            auto& m_t = get_or_init(m_, params);
-            auto& v_t = get_or_init(v_, params);
-
-            for (size_t i = 0; i < params.size(); ++i) {
-                // mt = β1·mt + (1−β1)·gt
-                m_t.begin()[i] = beta1_ * m_t.begin()[i] + (1 - beta1_) * grads.cbegin()[i];
-                // vt = β2·vt + (1−β2)·(gt²)
-                v_t.begin()[i] = beta2_ * v_t.begin()[i] + (1 - beta2_) * grads.cbegin()[i] * grads.cbegin()[i];
-
-                // Bias correction
-                T m_hat = m_t.begin()[i] / (1 - std::pow(beta1_, static_cast<T>(t_)));
-                T v_hat = v_t.begin()[i] / (1 - std::pow(beta2_, static_cast<T>(t_)));
-
-                // Update rule
-                params.begin()[i] -= lr_ * m_hat / (std::sqrt(v_hat) + epsilon_);
+            // Corrección de sesgo: una potencia por paso, no por elemento
+            const T c1 = 1 / (1 - std::pow(beta1_, static_cast<T>(t_)));
+            const T c2 = 1 / (1 - std::pow(beta2_, static_cast<T>(t_)));
+            const T b1 = beta1_, b2 = beta2_, lr = lr_, eps = epsilon_;
+
+            for (size_t id = 0; id < params_.size(); ++id) {
+                T* __restrict w = params_[id].value.data();
+                const T* __restrict g = params_[id].gradient.data();
+                T* __restrict m = m_.data() + offsets_[id];
+                T* __restrict v = v_.data() + offsets_[id];
+                const size_t n = params_[id].value.size();
+                for (size_t i = 0; i < n; ++i) {
+                    // mt = β1·mt + (1−β1)·gt ;  vt = β2·vt + (1−β2)·(gt²)
+                    m[i] = b1 * m[i] + (1 - b1) * g[i];
+                    v[i] = b2 * v[i] + (1 - b2) * g[i] * g[i];
+                    w[i] -= lr * (m[i] * c1) / (std::sqrt(v[i] * c2) + eps);
+                }
             }
         }
     };
@@ -13,14 +13,21 @@
 #include <initializer_list>
 #include <functional>
 #include <numeric>
+#include <span>
+#include <type_traits>
+#include "tensor_gemm.h"
+#include "tensor_expr.h"
+#include "tensor_alloc.h"
 
 namespace utec::algebra {
 
-    template <typename T = int, std::size_t Rank = 0>
+    // Alloc is the storage policy: PooledAllocator recycles buffers across
+    // iterations, AlignedAllocator always goes to the heap (see tensor_alloc.h)
+    template <typename T = int, std::size_t Rank = 0, typename Alloc = PooledAllocator<T>>
     class Tensor {
     private:
         std::array<std::size_t, Rank> dim{};
-        std::vector<T> arr;
+        std::vector<T, Alloc> arr;
 
         static void ThrowDimensionMatchException(const std::string& e) {
             throw std::invalid_argument("Number of dimensions do not match with " + e);
@@ -81,6 +88,10 @@ namespace utec::algebra {
         }
 
     public:
+        using value_type = T;
+        using allocator_type = Alloc;
+        static constexpr std::size_t rank = Rank;
+
         // Default constructor: creates 1x1x...x1 tensor
         Tensor() {
             dim.fill(1);
@@ -102,6 +113,25 @@ namespace utec::algebra {
         Tensor(Tensor&& other) noexcept = default;
         Tensor& operator=(Tensor&& other) noexcept = default;
 
+        // Materializes an element-wise expression in a single pass
+        template<expr::Expression E>
+            requires std::is_same_v<typename E::value_type, T> && (E::rank == Rank)
+        Tensor(const E& e) : dim(e.shape()) {
+            arr.resize(get_total_dim());
+            expr::evaluate(e, dim, arr.data(), arr.size());
+        }
+
+        // Evaluates in place when the shape is unchanged (an operand that is
+        // *this is then read at the same index it is written to)
+        template<expr::Expression E>
+            requires std::is_same_v<typename E::value_type, T> && (E::rank == Rank)
+        Tensor& operator=(const E& e) {
+            const auto shape = e.shape();
+            if (shape != dim) return *this = Tensor(e);
+            expr::evaluate(e, dim, arr.data(), arr.size());
+            return *this;
+        }
+
         void fill(const T& value) noexcept {
             std::fill(arr.begin(), arr.end(), value);
         }
@@ -125,7 +155,10 @@ namespace utec::algebra {
 
         const std::array<std::size_t, Rank>& shape() const noexcept { return dim; }
         std::size_t size() const noexcept { return arr.size(); }
-        std::vector<T> data() const { return arr; }
+        std::vector<T> data() const { return {arr.begin(), arr.end()}; }
+        // Contiguous row-major storage, without copying
+        std::span<T> span() noexcept { return arr; }
+        std::span<const T> span() const noexcept { return arr; }
 
         // Access bounds
         auto begin()  { return arr.begin(); }
@@ -162,30 +195,10 @@ namespace utec::algebra {
         }
 
         // Apply binary operation with broadcasting
-        void apply(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B, const std::function<T(T, T)>& op) {
-            auto shape_A = A.shape();
-            auto shape_B = B.shape();
-            auto shape_C = broadcast_shape(shape_A, shape_B);
-
-            dim = shape_C;
-            arr.resize(get_total_dim());
-            std::size_t total = get_total_dim();
-
-            for (std::size_t i = 0; i < total; ++i) {
-                std::array<std::size_t, Rank> idx{};
-                std::size_t rem = i;
-                for (int r = Rank - 1; r >= 0; --r) {
-                    idx[r] = rem % dim[r];
-                    rem /= dim[r];
-                }
-                std::array<std::size_t, Rank> idxA{}, idxB{};
-                for (std::size_t r = 0; r < Rank; ++r) {
-                    idxA[r] = (shape_A[r] == 1 ? 0 : idx[r]);
-                    idxB[r] = (shape_B[r] == 1 ? 0 : idx[r]);
-                }
-                get_element_by_list(idx.data()) =
-                    op(A.get_element_by_list(idxA.data()), B.get_element_by_list(idxB.data()));
-            }
+        template<class operation>
+        void apply(const Tensor& A, const Tensor& B, operation op) {
+            using Leaf = expr::TensorLeaf<T, Rank, const Tensor&>;
+            *this = Tensor(expr::BinaryExpr<operation, Leaf, Leaf>(Leaf(A), Leaf(B), std::move(op)));
         }
 
         // Apply scalar operation
@@ -195,7 +208,7 @@ namespace utec::algebra {
         }
 
         // Print
-        friend std::ostream& operator<<(std::ostream& os, const Tensor<T, Rank>& t) {
+        friend std::ostream& operator<<(std::ostream& os, const Tensor& t) {
             t.print_recursive(os, 0, 0);
             return os;
         }
@@ -204,67 +217,17 @@ namespace utec::algebra {
         template<typename U, std::size_t R>
         friend Tensor<U, R> transpose_2d(const Tensor<U, R>& t);
         template<typename U, std::size_t R>
-        friend Tensor<U, R> matrix_product(const Tensor<U, R>& A, const Tensor<U, R>& B);
+        friend void matrix_product(const Tensor<U, R>& A, const Tensor<U, R>& B, Tensor<U, R>& C);
+        template<typename U, std::size_t R>
+        friend void matmul_tn(const Tensor<U, R>& A, const Tensor<U, R>& B, Tensor<U, R>& C);
+        template<typename U, std::size_t R>
+        friend void matmul_nt(const Tensor<U, R>& A, const Tensor<U, R>& B, Tensor<U, R>& C);
     };
 
-    // Tensor-tensor operators
-    template<typename T, std::size_t Rank>
-    Tensor<T, Rank> operator+(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B) {
-        Tensor<T, Rank> result;
-        result.apply(A, B, [](T a, T b) { return a + b; });
-        return result;
-    }
-    template<typename T, std::size_t Rank>
-    Tensor<T, Rank> operator-(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B) {
-        Tensor<T, Rank> result;
-        result.apply(A, B, [](T a, T b) { return a - b; });
-        return result;
-    }
-    template<typename T, std::size_t Rank>
-    Tensor<T, Rank> operator*(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B) {
-        Tensor<T, Rank> result;
-        result.apply(A, B, [](T a, T b) { return a * b; });
-        return result;
-    }
-
-    // Tensor-scalar operators
-    template<typename T, std::size_t Rank, typename T_scalar>
-    Tensor<T, Rank> operator+(const Tensor<T, Rank>& t, T_scalar scalar) {
-        Tensor<T, Rank> result = t;
-        result.apply(scalar, [](T a, T_scalar e) { return a + e; });
-        return result;
-    }
-    template<typename T, std::size_t Rank, typename T_scalar>
-    Tensor<T, Rank> operator+(T_scalar scalar, const Tensor<T, Rank>& t) {
-        return t + scalar;
-    }
-    template<typename T, std::size_t Rank, typename T_scalar>
-    Tensor<T, Rank> operator*(const Tensor<T, Rank>& t, T_scalar scalar) {
-        Tensor<T, Rank> result = t;
-        result.apply(scalar, [](T a, T_scalar e) { return a * e; });
-        return result;
-    }
-    template<typename T, std::size_t Rank, typename T_scalar>
-    Tensor<T, Rank> operator*(T_scalar scalar, const Tensor<T, Rank>& t) {
-        Tensor<T, Rank> result = t * scalar;
-        return result;
-    }
-    template<typename T, std::size_t Rank, typename T_scalar>
-    Tensor<T, Rank> operator-(const Tensor<T, Rank>& t, T_scalar scalar) {
-        Tensor<T, Rank> result = t;
-        result.apply(scalar, [](T a, T_scalar e) { return a - e; });
-        return result;
-    }
-    template<typename T, std::size_t Rank, typename T_scalar>
-    Tensor<T, Rank> operator-(T_scalar scalar, const Tensor<T, Rank>& t) {
-        Tensor<T, Rank> result = t - scalar;
-        return -1 * result;
-    }
-    template<typename T, std::size_t Rank, typename T_scalar>
-    Tensor<T, Rank> operator/(const Tensor<T, Rank>& t, T_scalar scalar) {
-        Tensor<T, Rank> result = t;
-        result.apply(scalar, [](T a, T_scalar e) { return a / e; });
-        return result;
+    // Element-wise operators (+, -, * and scalar variants) live in tensor_expr.h
+    template<expr::Expression E>
+    std::ostream& operator<<(std::ostream& os, const E& e) {
+        return os << Tensor<typename E::value_type, E::rank>(e);
     }
 
     // Transpose 2D: swaps the last two dimensions, keeping batch dims
@@ -289,12 +252,14 @@ namespace utec::algebra {
         return r;
     }
 
-    // Matrix product on last two dimensions; batch dims must match
+    // Matrix product on last two dimensions; batch dims must match.
+    // Writes into C, reusing its storage when the capacity already fits (C must not alias A or B)
     template<typename T, std::size_t Rank>
-    Tensor<T, Rank> matrix_product(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B) {
+    void matrix_product(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B, Tensor<T, Rank>& C) {
         if constexpr (Rank < 2) {
             throw std::invalid_argument("Need at least 2D tensors for matrix multiplication");
         }
+        if (&C == &A || &C == &B) throw std::invalid_argument("Output tensor must not alias an operand");
         auto sA = A.shape(), sB = B.shape();
         const std::size_t M = sA[Rank-2], K = sA[Rank-1];
         const std::size_t K2 = sB[Rank-2], N = sB[Rank-1];
@@ -302,25 +267,90 @@ namespace utec::algebra {
         for (std::size_t i = 0; i < Rank-2; ++i)
             if (sA[i] != sB[i])
                 throw std::invalid_argument("Matrix dimensions are compatible for multiplication BUT Batch dimensions do not match");
-        Tensor<T, Rank> C;
         for (std::size_t i = 0; i < Rank-2; ++i) C.dim[i] = sA[i];
         C.dim[Rank-2] = M; C.dim[Rank-1] = N;
         C.arr.resize(C.get_total_dim());
-        std::size_t total = C.get_total_dim();
-        for (std::size_t i = 0; i < total; ++i) {
-            std::array<std::size_t, Rank> idx, idxA, idxB;
-            std::size_t rem = i;
-            for (int d = Rank-1; d >= 0; --d) { idx[d] = rem % C.dim[d]; rem /= C.dim[d]; }
-            // setup batch indices
-            for (std::size_t d = 0; d < Rank-2; ++d) idxA[d] = idxB[d] = idx[d];
-            T sum = T{};
-            for (std::size_t k = 0; k < K; ++k) {
-                idxA[Rank-2] = idx[Rank-2]; idxA[Rank-1] = k;
-                idxB[Rank-2] = k;           idxB[Rank-1] = idx[Rank-1];
-                sum += A.get_element_by_list(idxA.data()) * B.get_element_by_list(idxB.data());
+        // Batch dims are outermost, so every (M x K) * (K x N) slice is contiguous
+        std::size_t batches = 1;
+        for (std::size_t i = 0; i < Rank-2; ++i) batches *= sA[i];
+        for (std::size_t b = 0; b < batches; ++b) {
+            gemm::gemm<T>(M, N, K,
+                          {A.arr.data() + b * M * K, K, 1},
+                          {B.arr.data() + b * K * N, N, 1},
+                          C.arr.data() + b * M * N, N);
+        }
+    }
+
+    template<typename T, std::size_t Rank>
+    Tensor<T, Rank> matrix_product(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B) {
+        Tensor<T, Rank> C;
+        matrix_product(A, B, C);
+        return C;
+    }
+
+    namespace detail {
+        // Shared by matmul_tn / matmul_nt: checks batch dims, shapes C as (batch..., M, N)
+        // and runs one strided GEMM per batch slice
+        template<typename T, std::size_t Rank>
+        void strided_product(const std::array<std::size_t, Rank>& sA, const std::array<std::size_t, Rank>& sB,
+                             std::size_t M, std::size_t N, std::size_t K,
+                             const T* a, std::size_t a_rs, std::size_t a_cs,
+                             const T* b, std::size_t b_rs, std::size_t b_cs,
+                             std::array<std::size_t, Rank>& dim, std::vector<T, PooledAllocator<T>>& c) {
+            std::size_t batches = 1;
+            for (std::size_t i = 0; i < Rank-2; ++i) {
+                if (sA[i] != sB[i])
+                    throw std::invalid_argument("Matrix dimensions are compatible for multiplication BUT Batch dimensions do not match");
+                dim[i] = sA[i];
+                batches *= sA[i];
             }
-            C.get_element_by_list(idx.data()) = sum;
+            dim[Rank-2] = M; dim[Rank-1] = N;
+            c.resize(batches * M * N);
+            for (std::size_t bt = 0; bt < batches; ++bt)
+                gemm::gemm<T>(M, N, K, {a + bt * M * K, a_rs, a_cs}, {b + bt * K * N, b_rs, b_cs},
+                              c.data() + bt * M * N, N);
         }
+    }
+
+    // C = Aᵀ * B on the last two dimensions: A is (K x M), B is (K x N), C is (M x N).
+    // A is read in its stored layout (no transposed copy); C must not alias A or B
+    template<typename T, std::size_t Rank>
+    void matmul_tn(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B, Tensor<T, Rank>& C) {
+        if constexpr (Rank < 2) {
+            throw std::invalid_argument("Need at least 2D tensors for matrix multiplication");
+        }
+        if (&C == &A || &C == &B) throw std::invalid_argument("Output tensor must not alias an operand");
+        const std::size_t K = A.dim[Rank-2], M = A.dim[Rank-1];
+        const std::size_t N = B.dim[Rank-1];
+        if (B.dim[Rank-2] != K) throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        detail::strided_product(A.dim, B.dim, M, N, K, A.arr.data(), 1, M, B.arr.data(), N, 1, C.dim, C.arr);
+    }
+
+    // C = A * Bᵀ on the last two dimensions: A is (M x K), B is (N x K), C is (M x N).
+    // B is read in its stored layout (no transposed copy); C must not alias A or B
+    template<typename T, std::size_t Rank>
+    void matmul_nt(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B, Tensor<T, Rank>& C) {
+        if constexpr (Rank < 2) {
+            throw std::invalid_argument("Need at least 2D tensors for matrix multiplication");
+        }
+        if (&C == &A || &C == &B) throw std::invalid_argument("Output tensor must not alias an operand");
+        const std::size_t M = A.dim[Rank-2], K = A.dim[Rank-1];
+        const std::size_t N = B.dim[Rank-2];
+        if (B.dim[Rank-1] != K) throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        detail::strided_product(A.dim, B.dim, M, N, K, A.arr.data(), K, 1, B.arr.data(), 1, K, C.dim, C.arr);
+    }
+
+    template<typename T, std::size_t Rank>
+    Tensor<T, Rank> matmul_tn(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B) {
+        Tensor<T, Rank> C;
+        matmul_tn(A, B, C);
+        return C;
+    }
+
+    template<typename T, std::size_t Rank>
+    Tensor<T, Rank> matmul_nt(const Tensor<T, Rank>& A, const Tensor<T, Rank>& B) {
+        Tensor<T, Rank> C;
+        matmul_nt(A, B, C);
         return C;
     }
 }
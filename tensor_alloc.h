@@ -0,0 +1,218 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_ALLOC_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_ALLOC_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <vector>
+
+// Storage allocators for Tensor. Both hand out 64-byte aligned blocks (one
+// cache line, a full AVX-512 register). PooledAllocator, the default, rounds
+// each request up to a power-of-two size class and keeps freed blocks in a
+// per-thread cache, so the same shapes allocated every training iteration are
+// recycled instead of going back to the heap. The counters cover tensor
+// storage only and are meant to check that steady-state training stops
+// touching the heap.
+namespace utec::algebra {
+
+    struct AllocationStats {
+        std::size_t heap_allocations = 0;  // blocks obtained from operator new
+        std::size_t heap_bytes = 0;        // bytes of those blocks
+        std::size_t pool_hits = 0;         // requests served from a cached block
+        std::size_t releases = 0;          // blocks handed back (to the cache or the heap)
+    };
+
+    namespace detail {
+
+        constexpr std::size_t storage_alignment = 64;
+        constexpr std::size_t min_class_shift = 6;    // 64 B
+        constexpr std::size_t max_class_shift = 26;   // 64 MiB, larger blocks bypass the pool
+        constexpr std::size_t size_classes = max_class_shift - min_class_shift + 1;
+        constexpr std::size_t max_cached_bytes = std::size_t{256} << 20; // per thread
+        constexpr std::size_t no_class = std::numeric_limits<std::size_t>::max();
+
+        struct Counters {
+            std::atomic<std::size_t> heap_allocations{0};
+            std::atomic<std::size_t> heap_bytes{0};
+            std::atomic<std::size_t> pool_hits{0};
+            std::atomic<std::size_t> releases{0};
+        };
+        inline Counters counters;
+
+        inline void* heap_allocate(std::size_t bytes) {
+            void* p = ::operator new(bytes, std::align_val_t{storage_alignment});
+            counters.heap_allocations.fetch_add(1, std::memory_order_relaxed);
+            counters.heap_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            return p;
+        }
+
+        inline void heap_release(void* p) noexcept {
+            ::operator delete(p, std::align_val_t{storage_alignment});
+        }
+
+        inline std::size_t size_class(std::size_t bytes) noexcept {
+            std::size_t shift = min_class_shift;
+            while (shift <= max_class_shift && (std::size_t{1} << shift) < bytes) ++shift;
+            return shift <= max_class_shift ? shift - min_class_shift : no_class;
+        }
+
+        // Pooled blocks carry their size class in a header one alignment unit
+        // before the storage (no_class for blocks allocated at their exact
+        // size). Release trusts the header, not the size passed back, so a
+        // block only ever re-enters the cache in the class it was built for
+        constexpr std::size_t header_bytes = storage_alignment;
+
+        inline std::size_t block_class(void* p) noexcept {
+            return *std::launder(reinterpret_cast<std::size_t*>(static_cast<char*>(p) - header_bytes));
+        }
+
+        inline void* block_start(void* p) noexcept {
+            return static_cast<char*>(p) - header_bytes;
+        }
+
+        // Trivially destructible, so it stays readable after the cache is gone
+        inline bool& cache_destroyed() noexcept {
+            thread_local bool destroyed = false;
+            return destroyed;
+        }
+
+        // Free lists per size class. A block freed on another thread than the
+        // one that allocated it simply joins that thread's cache, under the
+        // class recorded in its header
+        class BlockCache {
+            std::array<std::vector<void*>, size_classes> free_;
+            std::size_t cached_bytes_ = 0;
+
+        public:
+            BlockCache() = default;
+            BlockCache(const BlockCache&) = delete;
+            BlockCache& operator=(const BlockCache&) = delete;
+
+            ~BlockCache() {
+                for (auto& list : free_)
+                    for (void* p : list) heap_release(block_start(p));
+                cache_destroyed() = true;
+            }
+
+            void* take(std::size_t cls) {
+                auto& list = free_[cls];
+                if (list.empty()) return nullptr;
+                void* p = list.back();
+                list.pop_back();
+                cached_bytes_ -= std::size_t{1} << (cls + min_class_shift);
+                return p;
+            }
+
+            bool give(void* p, std::size_t cls) {
+                const std::size_t bytes = std::size_t{1} << (cls + min_class_shift);
+                if (cached_bytes_ + bytes > max_cached_bytes) return false;
+                free_[cls].push_back(p);
+                cached_bytes_ += bytes;
+                return true;
+            }
+        };
+
+        inline BlockCache& block_cache() {
+            thread_local BlockCache cache;
+            return cache;
+        }
+
+        inline void* pooled_allocate(std::size_t bytes) {
+            // Once this thread's cache is gone the block is exact-size and never cached
+            const std::size_t cls = cache_destroyed() ? no_class : size_class(bytes);
+            if (cls != no_class) {
+                if (void* p = block_cache().take(cls)) {
+                    counters.pool_hits.fetch_add(1, std::memory_order_relaxed);
+                    return p;
+                }
+                bytes = std::size_t{1} << (cls + min_class_shift);
+            }
+            void* p = static_cast<char*>(heap_allocate(header_bytes + bytes)) + header_bytes;
+            ::new (block_start(p)) std::size_t(cls);
+            return p;
+        }
+
+        inline void pooled_release(void* p, std::size_t bytes) noexcept {
+            counters.releases.fetch_add(1, std::memory_order_relaxed);
+            const std::size_t cls = block_class(p);
+            // The size handed back must fit the recorded class; if not, don't cache it
+            if (cls == no_class || cache_destroyed() || size_class(bytes) > cls)
+                return heap_release(block_start(p));
+            try {
+                if (block_cache().give(p, cls)) return;
+            } catch (...) {
+                // Growing the free list failed: the block goes back to the heap
+            }
+            heap_release(block_start(p));
+        }
+
+        template<typename T>
+        std::size_t storage_bytes(std::size_t n) {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+            return n * sizeof(T);
+        }
+
+    }
+
+    inline AllocationStats allocation_stats() noexcept {
+        return {detail::counters.heap_allocations.load(std::memory_order_relaxed),
+                detail::counters.heap_bytes.load(std::memory_order_relaxed),
+                detail::counters.pool_hits.load(std::memory_order_relaxed),
+                detail::counters.releases.load(std::memory_order_relaxed)};
+    }
+
+    inline void reset_allocation_stats() noexcept {
+        detail::counters.heap_allocations.store(0, std::memory_order_relaxed);
+        detail::counters.heap_bytes.store(0, std::memory_order_relaxed);
+        detail::counters.pool_hits.store(0, std::memory_order_relaxed);
+        detail::counters.releases.store(0, std::memory_order_relaxed);
+    }
+
+    // 64-byte aligned, straight to the heap on every request
+    template<typename T>
+    struct AlignedAllocator {
+        using value_type = T;
+
+        AlignedAllocator() noexcept = default;
+        template<typename U>
+        AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(detail::heap_allocate(detail::storage_bytes<T>(n)));
+        }
+        void deallocate(T* p, std::size_t) noexcept {
+            detail::counters.releases.fetch_add(1, std::memory_order_relaxed);
+            detail::heap_release(p);
+        }
+
+        friend bool operator==(const AlignedAllocator&, const AlignedAllocator&) noexcept { return true; }
+    };
+
+    // 64-byte aligned, recycled through the per-thread size-class cache
+    template<typename T>
+    struct PooledAllocator {
+        using value_type = T;
+
+        PooledAllocator() noexcept = default;
+        template<typename U>
+        PooledAllocator(const PooledAllocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(detail::pooled_allocate(detail::storage_bytes<T>(n)));
+        }
+        void deallocate(T* p, std::size_t n) noexcept {
+            detail::pooled_release(p, n * sizeof(T));
+        }
+
+        friend bool operator==(const PooledAllocator&, const PooledAllocator&) noexcept { return true; }
+    };
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_ALLOC_H
@@ -0,0 +1,333 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_EXPR_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_EXPR_H
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "tensor_alloc.h"
+
+// Lazy element-wise expressions over Tensor. An operator such as A - B or
+// t * 2 returns a small node that only records its operands; the whole chain
+// is evaluated in one loop when it is assigned to a Tensor, so
+// (A - B) * s allocates once and reads each input once. Operators are plain
+// function objects (inlined, no std::function). When every operand has the
+// result's exact shape the loop runs over flat storage; otherwise the
+// broadcast engine in evaluate() takes over.
+namespace utec::algebra {
+
+    template<typename T, std::size_t Rank, typename Alloc>
+    class Tensor;
+
+    namespace expr {
+
+        template<typename E>
+        concept Expression = requires { typename std::remove_cvref_t<E>::expression_tag; };
+
+        template<typename X>
+        struct is_tensor : std::false_type {};
+        template<typename T, std::size_t Rank, typename Alloc>
+        struct is_tensor<Tensor<T, Rank, Alloc>> : std::true_type {};
+
+        // Anything that can be an array operand of an element-wise operator
+        template<typename X>
+        concept TensorLike = is_tensor<std::remove_cvref_t<X>>::value || Expression<X>;
+
+        template<typename X>
+        concept Scalar = std::is_arithmetic_v<std::remove_cvref_t<X>>;
+
+        // Leaf over a Tensor: held by reference for lvalues, by value for
+        // temporaries so that expressions never outlive their operands
+        template<typename T, std::size_t Rank, typename Storage>
+        class TensorLeaf {
+            Storage t_;
+        public:
+            using expression_tag = void;
+            using value_type = T;
+            static constexpr std::size_t rank = Rank;
+            static constexpr bool is_scalar = false;
+
+            template<typename U>
+            explicit TensorLeaf(U&& t) : t_(std::forward<U>(t)) {}
+
+            static constexpr std::size_t leaves = 1;
+
+            const std::array<std::size_t, Rank>& shape() const noexcept { return t_.shape(); }
+            bool matches(const std::array<std::size_t, Rank>& s) const noexcept { return t_.shape() == s; }
+            T operator[](std::size_t i) const { return t_.cbegin()[i]; }
+
+            // Leaves are numbered left to right; the engine keeps one row pointer per leaf
+            template<std::size_t Offset>
+            void collect(const T** data, const std::array<std::size_t, Rank>** shapes) const {
+                data[Offset] = t_.span().data();
+                shapes[Offset] = &t_.shape();
+            }
+
+            // Bit Offset of Mask set: this operand is constant along the row
+            template<std::size_t Offset, unsigned Mask>
+            T load(const T* const* rows, std::size_t j) const {
+                if constexpr ((Mask >> Offset) & 1u) return rows[Offset][0];
+                else return rows[Offset][j];
+            }
+
+            template<std::size_t Offset>
+            T load_strided(const T* const* rows, const std::size_t* steps, std::size_t j) const {
+                return rows[Offset][j * steps[Offset]];
+            }
+        };
+
+        template<typename S>
+        class ScalarLeaf {
+            S value_;
+        public:
+            using expression_tag = void;
+            static constexpr bool is_scalar = true;
+
+            explicit ScalarLeaf(S value) : value_(value) {}
+
+            static constexpr std::size_t leaves = 0;
+
+            template<std::size_t Rank>
+            bool matches(const std::array<std::size_t, Rank>&) const noexcept { return true; }
+            S operator[](std::size_t) const { return value_; }
+
+            template<std::size_t Offset, typename T, std::size_t Rank>
+            void collect(const T**, const std::array<std::size_t, Rank>**) const {}
+            template<std::size_t Offset, unsigned Mask, typename T>
+            S load(const T* const*, std::size_t) const { return value_; }
+            template<std::size_t Offset, typename T>
+            S load_strided(const T* const*, const std::size_t*, std::size_t) const { return value_; }
+        };
+
+        template<typename L, typename R>
+        struct operand_traits {
+            using array_side = std::conditional_t<L::is_scalar, R, L>;
+            using value_type = typename array_side::value_type;
+            static constexpr std::size_t rank = array_side::rank;
+        };
+
+        // Each step is cast back to T, as if every intermediate were a Tensor<T, Rank>
+        template<typename Op, typename L, typename R>
+        class BinaryExpr {
+            L l_;
+            R r_;
+            [[no_unique_address]] Op op_;
+        public:
+            using expression_tag = void;
+            using value_type = typename operand_traits<L, R>::value_type;
+            static constexpr std::size_t rank = operand_traits<L, R>::rank;
+            static constexpr bool is_scalar = false;
+
+            BinaryExpr(L l, R r, Op op = Op{}) : l_(std::move(l)), r_(std::move(r)), op_(std::move(op)) {}
+
+            std::array<std::size_t, rank> shape() const {
+                if constexpr (L::is_scalar) return r_.shape();
+                else if constexpr (R::is_scalar) return l_.shape();
+                else return Tensor<value_type, rank, PooledAllocator<value_type>>::broadcast_shape(l_.shape(), r_.shape());
+            }
+
+            bool matches(const std::array<std::size_t, rank>& s) const {
+                return l_.matches(s) && r_.matches(s);
+            }
+
+            value_type operator[](std::size_t i) const {
+                return static_cast<value_type>(op_(l_[i], r_[i]));
+            }
+
+            static constexpr std::size_t leaves = L::leaves + R::leaves;
+
+            template<std::size_t Offset>
+            void collect(const value_type** data, const std::array<std::size_t, rank>** shapes) const {
+                l_.template collect<Offset>(data, shapes);
+                r_.template collect<Offset + L::leaves>(data, shapes);
+            }
+
+            template<std::size_t Offset, unsigned Mask>
+            value_type load(const value_type* const* rows, std::size_t j) const {
+                return static_cast<value_type>(op_(l_.template load<Offset, Mask>(rows, j),
+                                                   r_.template load<Offset + L::leaves, Mask>(rows, j)));
+            }
+
+            template<std::size_t Offset>
+            value_type load_strided(const value_type* const* rows, const std::size_t* steps, std::size_t j) const {
+                return static_cast<value_type>(op_(l_.template load_strided<Offset>(rows, steps, j),
+                                                   r_.template load_strided<Offset + L::leaves>(rows, steps, j)));
+            }
+        };
+
+        // Wraps an operator argument into an expression node
+        template<typename X>
+        auto wrap(X&& x) {
+            using D = std::remove_cvref_t<X>;
+            if constexpr (Expression<D>) {
+                return D(std::forward<X>(x));
+            } else if constexpr (is_tensor<D>::value) {
+                using Storage = std::conditional_t<std::is_lvalue_reference_v<X>, const D&, D>;
+                return TensorLeaf<typename D::value_type, D::rank, Storage>(std::forward<X>(x));
+            } else {
+                return ScalarLeaf<D>(x);
+            }
+        }
+
+        template<typename X>
+        using node_t = decltype(wrap(std::declval<X>()));
+
+        template<typename Op, typename L, typename R>
+        auto make_binary(L&& l, R&& r) {
+            return BinaryExpr<Op, node_t<L>, node_t<R>>(wrap(std::forward<L>(l)), wrap(std::forward<R>(r)));
+        }
+
+        // Both array operands must agree on element type and rank
+        template<typename L, typename R>
+        concept Compatible = TensorLike<L> && TensorLike<R> &&
+            std::is_same_v<typename node_t<L>::value_type, typename node_t<R>::value_type> &&
+            node_t<L>::rank == node_t<R>::rank;
+
+        // Up to this many tensor operands every broadcast pattern of the inner
+        // loop gets its own instantiation (2^N); beyond it a strided loop is used
+        constexpr std::size_t max_specialized_leaves = 4;
+
+        // One output row: operands flagged in Mask are read once per row
+        // (column broadcast, all-ones shape), the rest are contiguous. With the
+        // pattern fixed at compile time the loop auto-vectorizes
+        template<unsigned Mask, typename E, typename T>
+        void row_kernel(const E& e, const T* const* rows, const std::size_t*, T* out, std::size_t len) {
+            for (std::size_t j = 0; j < len; ++j) out[j] = e.template load<0, Mask>(rows, j);
+        }
+
+        template<typename E, typename T>
+        void strided_row_kernel(const E& e, const T* const* rows, const std::size_t* steps, T* out, std::size_t len) {
+            for (std::size_t j = 0; j < len; ++j) out[j] = e.template load_strided<0>(rows, steps, j);
+        }
+
+        template<typename E, typename T>
+        using RowKernel = void (*)(const E&, const T* const*, const std::size_t*, T*, std::size_t);
+
+        template<typename E, typename T, unsigned... Masks>
+        RowKernel<E, T> pick_row_kernel(unsigned mask, std::integer_sequence<unsigned, Masks...>) {
+            static constexpr RowKernel<E, T> table[] = {&row_kernel<Masks, E, T>...};
+            return table[mask];
+        }
+
+        // Broadcast plan: per-operand strides over the output dimensions
+        // (0 where the operand broadcasts). Size-1 output dimensions are
+        // dropped and neighbouring dimensions that every operand walks
+        // contiguously, or broadcasts alike, are merged. The last merged
+        // dimension is the inner loop; there each operand has step 1 or 0
+        template<std::size_t N, std::size_t Rank>
+        struct BroadcastPlan {
+            std::size_t rank = 0;
+            std::array<std::size_t, Rank> extent{};
+            std::array<std::array<std::size_t, Rank>, N> stride{};
+
+            BroadcastPlan(const std::array<std::size_t, Rank>& shape, const std::array<std::size_t, Rank>* const* shapes) {
+                std::array<std::array<std::size_t, Rank>, N> own{}; // row-major strides of each operand
+                for (std::size_t k = 0; k < N; ++k) {
+                    std::size_t st = 1;
+                    for (std::size_t d = Rank; d-- > 0;) {
+                        own[k][d] = st;
+                        st *= (*shapes[k])[d];
+                    }
+                }
+                for (std::size_t d = 0; d < Rank; ++d) {
+                    if (shape[d] == 1) continue;
+                    bool merge = rank > 0;
+                    std::array<std::size_t, N> eff{};
+                    for (std::size_t k = 0; k < N; ++k) {
+                        eff[k] = (*shapes[k])[d] == 1 ? 0 : own[k][d];
+                        const std::size_t prev = merge ? stride[k][rank - 1] : 0;
+                        merge = merge && (eff[k] == 0 ? prev == 0 : prev == eff[k] * shape[d]);
+                    }
+                    if (merge) {
+                        extent[rank - 1] *= shape[d];
+                    } else {
+                        extent[rank] = shape[d];
+                        ++rank;
+                    }
+                    for (std::size_t k = 0; k < N; ++k) stride[k][rank - 1] = eff[k];
+                }
+            }
+        };
+
+        // Writes e into out, whose shape must already be e.shape()
+        template<typename E, typename T, std::size_t Rank>
+        void evaluate(const E& e, const std::array<std::size_t, Rank>& shape, T* out, std::size_t n) {
+            if (e.matches(shape)) {
+                for (std::size_t i = 0; i < n; ++i) out[i] = e[i];
+                return;
+            }
+
+            constexpr std::size_t N = E::leaves;
+            std::array<const T*, N> data{};
+            std::array<const std::array<std::size_t, Rank>*, N> shapes{};
+            e.template collect<0>(data.data(), shapes.data());
+            const BroadcastPlan<N, Rank> plan(shape, shapes.data());
+
+            const std::size_t inner = plan.rank - 1;
+            const std::size_t len = plan.extent[inner];
+            if (n == 0 || len == 0) return; // an empty dimension leaves nothing to write
+            std::array<std::size_t, N> steps{};
+            unsigned mask = 0;
+            for (std::size_t k = 0; k < N; ++k) {
+                steps[k] = plan.stride[k][inner];
+                if (steps[k] == 0) mask |= 1u << k;
+            }
+
+            RowKernel<E, T> kernel;
+            if constexpr (N <= max_specialized_leaves)
+                kernel = pick_row_kernel<E, T>(mask, std::make_integer_sequence<unsigned, (1u << N)>{});
+            else
+                kernel = &strided_row_kernel<E, T>;
+
+            // Odometer over the outer dimensions, moving each operand's row pointer by its stride
+            std::array<std::size_t, Rank> idx{};
+            std::array<std::size_t, N> offset{};
+            std::array<const T*, N> rows{};
+            for (std::size_t row = 0, count = n / len; row < count; ++row) {
+                for (std::size_t k = 0; k < N; ++k) rows[k] = data[k] + offset[k];
+                kernel(e, rows.data(), steps.data(), out + row * len, len);
+                for (std::size_t d = inner; d-- > 0;) {
+                    if (++idx[d] < plan.extent[d]) {
+                        for (std::size_t k = 0; k < N; ++k) offset[k] += plan.stride[k][d];
+                        break;
+                    }
+                    idx[d] = 0;
+                    for (std::size_t k = 0; k < N; ++k) offset[k] -= plan.stride[k][d] * (plan.extent[d] - 1);
+                }
+            }
+        }
+
+    }
+
+    // Tensor-tensor operators (with broadcasting)
+    template<typename L, typename R> requires expr::Compatible<L, R>
+    auto operator+(L&& A, R&& B) { return expr::make_binary<std::plus<>>(std::forward<L>(A), std::forward<R>(B)); }
+    template<typename L, typename R> requires expr::Compatible<L, R>
+    auto operator-(L&& A, R&& B) { return expr::make_binary<std::minus<>>(std::forward<L>(A), std::forward<R>(B)); }
+    template<typename L, typename R> requires expr::Compatible<L, R>
+    auto operator*(L&& A, R&& B) { return expr::make_binary<std::multiplies<>>(std::forward<L>(A), std::forward<R>(B)); }
+
+    // Tensor-scalar operators
+    template<expr::TensorLike X, expr::Scalar S>
+    auto operator+(X&& t, S scalar) { return expr::make_binary<std::plus<>>(std::forward<X>(t), scalar); }
+    template<expr::TensorLike X, expr::Scalar S>
+    auto operator+(S scalar, X&& t) { return expr::make_binary<std::plus<>>(scalar, std::forward<X>(t)); }
+    template<expr::TensorLike X, expr::Scalar S>
+    auto operator*(X&& t, S scalar) { return expr::make_binary<std::multiplies<>>(std::forward<X>(t), scalar); }
+    template<expr::TensorLike X, expr::Scalar S>
+    auto operator*(S scalar, X&& t) { return expr::make_binary<std::multiplies<>>(scalar, std::forward<X>(t)); }
+    template<expr::TensorLike X, expr::Scalar S>
+    auto operator-(X&& t, S scalar) { return expr::make_binary<std::minus<>>(std::forward<X>(t), scalar); }
+    template<expr::TensorLike X, expr::Scalar S>
+    auto operator-(S scalar, X&& t) { return expr::make_binary<std::minus<>>(scalar, std::forward<X>(t)); }
+    template<expr::TensorLike X, expr::Scalar S>
+    auto operator/(X&& t, S scalar) { return expr::make_binary<std::divides<>>(std::forward<X>(t), scalar); }
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_EXPR_H
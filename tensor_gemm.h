@@ -0,0 +1,319 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_GEMM_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_GEMM_H
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UTEC_GEMM_X86 1
+#include <immintrin.h>
+#endif
+
+// Packed, cache-blocked GEMM (C = A * B) over raw strided storage.
+// Follows the usual Goto/BLIS layering: B is packed into KC x NC panels (L3),
+// A into MC x KC blocks (L2), and a register-blocked MR x NR micro-kernel
+// walks both packed buffers linearly. The micro-kernel is picked at runtime
+// (AVX-512, AVX2+FMA or portable scalar).
+namespace utec::algebra::gemm {
+
+    constexpr std::size_t KC = 256;
+    constexpr std::size_t MC = 96;    // multiple of every kernel's MR
+    constexpr std::size_t NC = 2048;  // multiple of every kernel's NR
+    constexpr std::size_t MAX_TILE = 8 * 32;
+
+    // Read-only strided view: element (i, j) lives at ptr[i * rs + j * cs]
+    template<typename T>
+    struct MatrixRef {
+        const T* ptr;
+        std::size_t rs;
+        std::size_t cs;
+
+        const T* at(std::size_t i, std::size_t j) const { return ptr + i * rs + j * cs; }
+    };
+
+    // Micro-kernel: C[MR x NR] (+)= Apanel[kc x MR]^T * Bpanel[kc x NR] (+ bias).
+    // A non-null bias holds NR values added to every row in-register before the store
+    template<typename T>
+    struct Kernel {
+        const char* name;
+        std::size_t mr;
+        std::size_t nr;
+        void (*run)(std::size_t kc, const T* a, const T* b, T* c, std::size_t ldc, bool accumulate, const T* bias);
+    };
+
+    // Work fused into the store phase of gemm, so C is not swept again afterwards:
+    // bias (N values) is added in-register on the last K panel, then `finish`
+    // sees every completed mc x nr strip of C while it is still in L1.
+    // `row`/`col` give the strip's position in C
+    template<typename T>
+    struct Epilogue {
+        const T* bias = nullptr;
+        void (*finish)(void* ctx, T* c, std::size_t ldc, std::size_t row, std::size_t col,
+                       std::size_t m, std::size_t n) = nullptr;
+        void* ctx = nullptr;
+    };
+
+    namespace detail {
+
+        template<typename T, std::size_t MR, std::size_t NR>
+        void kernel_scalar(std::size_t kc, const T* a, const T* b, T* c, std::size_t ldc, bool accumulate,
+                           const T* bias) {
+            T ab[MR][NR] = {};
+            for (std::size_t k = 0; k < kc; ++k, a += MR, b += NR)
+                for (std::size_t r = 0; r < MR; ++r)
+                    for (std::size_t j = 0; j < NR; ++j)
+                        ab[r][j] += a[r] * b[j];
+            if (bias)
+                for (std::size_t r = 0; r < MR; ++r)
+                    for (std::size_t j = 0; j < NR; ++j)
+                        ab[r][j] += bias[j];
+            for (std::size_t r = 0; r < MR; ++r)
+                for (std::size_t j = 0; j < NR; ++j)
+                    c[r * ldc + j] = accumulate ? c[r * ldc + j] + ab[r][j] : ab[r][j];
+        }
+
+#ifdef UTEC_GEMM_X86
+        // 6 x 16 floats: 12 ymm accumulators, 2 B loads + 6 broadcasts per k
+        __attribute__((target("avx2,fma")))
+        inline void kernel_avx2_6x16(std::size_t kc, const float* a, const float* b,
+                                     float* c, std::size_t ldc, bool accumulate, const float* bias) {
+            __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+            __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+            __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+            __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+            __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+            __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+            for (std::size_t k = 0; k < kc; ++k, a += 6, b += 16) {
+                const __m256 b0 = _mm256_loadu_ps(b);
+                const __m256 b1 = _mm256_loadu_ps(b + 8);
+                __m256 av = _mm256_broadcast_ss(a + 0);
+                c00 = _mm256_fmadd_ps(av, b0, c00); c01 = _mm256_fmadd_ps(av, b1, c01);
+                av = _mm256_broadcast_ss(a + 1);
+                c10 = _mm256_fmadd_ps(av, b0, c10); c11 = _mm256_fmadd_ps(av, b1, c11);
+                av = _mm256_broadcast_ss(a + 2);
+                c20 = _mm256_fmadd_ps(av, b0, c20); c21 = _mm256_fmadd_ps(av, b1, c21);
+                av = _mm256_broadcast_ss(a + 3);
+                c30 = _mm256_fmadd_ps(av, b0, c30); c31 = _mm256_fmadd_ps(av, b1, c31);
+                av = _mm256_broadcast_ss(a + 4);
+                c40 = _mm256_fmadd_ps(av, b0, c40); c41 = _mm256_fmadd_ps(av, b1, c41);
+                av = _mm256_broadcast_ss(a + 5);
+                c50 = _mm256_fmadd_ps(av, b0, c50); c51 = _mm256_fmadd_ps(av, b1, c51);
+            }
+            const __m256 rows[6][2] = {{c00, c01}, {c10, c11}, {c20, c21},
+                                       {c30, c31}, {c40, c41}, {c50, c51}};
+            for (std::size_t r = 0; r < 6; ++r) {
+                float* cr = c + r * ldc;
+                __m256 lo = rows[r][0], hi = rows[r][1];
+                if (bias) {
+                    lo = _mm256_add_ps(lo, _mm256_loadu_ps(bias));
+                    hi = _mm256_add_ps(hi, _mm256_loadu_ps(bias + 8));
+                }
+                if (accumulate) {
+                    lo = _mm256_add_ps(lo, _mm256_loadu_ps(cr));
+                    hi = _mm256_add_ps(hi, _mm256_loadu_ps(cr + 8));
+                }
+                _mm256_storeu_ps(cr, lo);
+                _mm256_storeu_ps(cr + 8, hi);
+            }
+        }
+
+        // 6 x 32 floats: 12 zmm accumulators
+        __attribute__((target("avx512f")))
+        inline void kernel_avx512_6x32(std::size_t kc, const float* a, const float* b,
+                                       float* c, std::size_t ldc, bool accumulate, const float* bias) {
+            __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+            __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+            __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+            __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+            __m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+            __m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+            for (std::size_t k = 0; k < kc; ++k, a += 6, b += 32) {
+                const __m512 b0 = _mm512_loadu_ps(b);
+                const __m512 b1 = _mm512_loadu_ps(b + 16);
+                __m512 av = _mm512_set1_ps(a[0]);
+                c00 = _mm512_fmadd_ps(av, b0, c00); c01 = _mm512_fmadd_ps(av, b1, c01);
+                av = _mm512_set1_ps(a[1]);
+                c10 = _mm512_fmadd_ps(av, b0, c10); c11 = _mm512_fmadd_ps(av, b1, c11);
+                av = _mm512_set1_ps(a[2]);
+                c20 = _mm512_fmadd_ps(av, b0, c20); c21 = _mm512_fmadd_ps(av, b1, c21);
+                av = _mm512_set1_ps(a[3]);
+                c30 = _mm512_fmadd_ps(av, b0, c30); c31 = _mm512_fmadd_ps(av, b1, c31);
+                av = _mm512_set1_ps(a[4]);
+                c40 = _mm512_fmadd_ps(av, b0, c40); c41 = _mm512_fmadd_ps(av, b1, c41);
+                av = _mm512_set1_ps(a[5]);
+                c50 = _mm512_fmadd_ps(av, b0, c50); c51 = _mm512_fmadd_ps(av, b1, c51);
+            }
+            const __m512 rows[6][2] = {{c00, c01}, {c10, c11}, {c20, c21},
+                                       {c30, c31}, {c40, c41}, {c50, c51}};
+            for (std::size_t r = 0; r < 6; ++r) {
+                float* cr = c + r * ldc;
+                __m512 lo = rows[r][0], hi = rows[r][1];
+                if (bias) {
+                    lo = _mm512_add_ps(lo, _mm512_loadu_ps(bias));
+                    hi = _mm512_add_ps(hi, _mm512_loadu_ps(bias + 16));
+                }
+                if (accumulate) {
+                    lo = _mm512_add_ps(lo, _mm512_loadu_ps(cr));
+                    hi = _mm512_add_ps(hi, _mm512_loadu_ps(cr + 16));
+                }
+                _mm512_storeu_ps(cr, lo);
+                _mm512_storeu_ps(cr + 16, hi);
+            }
+        }
+#endif
+
+        // Packs an mc x kc block of A as consecutive MR-row slivers (k-major), zero padded
+        template<typename T>
+        void pack_a(std::size_t mc, std::size_t kc, MatrixRef<T> A, std::size_t mr, T* out) {
+            for (std::size_t i = 0; i < mc; i += mr) {
+                const std::size_t m = std::min(mr, mc - i);
+                if (A.rs == 1) {
+                    // A stored transposed (A^T row-major): each sliver column is contiguous
+                    for (std::size_t k = 0; k < kc; ++k, out += mr) {
+                        std::copy(A.at(i, k), A.at(i, k) + m, out);
+                        std::fill(out + m, out + mr, T{});
+                    }
+                } else {
+                    // Row-major A: stream each row along k, scatter into the sliver
+                    for (std::size_t r = 0; r < m; ++r) {
+                        const T* row = A.at(i + r, 0);
+                        for (std::size_t k = 0; k < kc; ++k) out[k * mr + r] = row[k * A.cs];
+                    }
+                    for (std::size_t k = 0; k < kc; ++k)
+                        std::fill(out + k * mr + m, out + (k + 1) * mr, T{});
+                    out += kc * mr;
+                }
+            }
+        }
+
+        // Packs a kc x nc panel of B as consecutive NR-column slivers (k-major), zero padded
+        template<typename T>
+        void pack_b(std::size_t kc, std::size_t nc, MatrixRef<T> B, std::size_t nr, T* out) {
+            for (std::size_t j = 0; j < nc; j += nr) {
+                const std::size_t n = std::min(nr, nc - j);
+                if (B.cs == 1) {
+                    for (std::size_t k = 0; k < kc; ++k, out += nr) {
+                        std::copy(B.at(k, j), B.at(k, j) + n, out);
+                        std::fill(out + n, out + nr, T{});
+                    }
+                } else {
+                    // B stored transposed (B^T row-major): walk each column along k
+                    for (std::size_t c = 0; c < n; ++c) {
+                        const T* col = B.at(0, j + c);
+                        for (std::size_t k = 0; k < kc; ++k) out[k * nr + c] = col[k * B.rs];
+                    }
+                    for (std::size_t k = 0; k < kc; ++k)
+                        std::fill(out + k * nr + n, out + (k + 1) * nr, T{});
+                    out += kc * nr;
+                }
+            }
+        }
+
+        template<typename T>
+        Kernel<T> pick_kernel(bool) {
+            return {"scalar", 4, 8, &kernel_scalar<T, 4, 8>};
+        }
+
+        template<>
+        inline Kernel<float> pick_kernel<float>(bool narrow) {
+#ifdef UTEC_GEMM_X86
+            __builtin_cpu_init();
+            const bool avx512 = __builtin_cpu_supports("avx512f");
+            const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            // A 32-wide tile would be half padding when N <= 16 (Dense layers with 16 units)
+            if (avx512 && !(narrow && avx2))
+                return {"avx512", 6, 32, &kernel_avx512_6x32};
+            if (avx2)
+                return {"avx2", 6, 16, &kernel_avx2_6x16};
+#endif
+            return {"scalar", 4, 8, &kernel_scalar<float, 4, 8>};
+        }
+
+    }
+
+    // Kernel chosen once per element type for the running CPU; `narrow` favours NR <= 16
+    template<typename T>
+    const Kernel<T>& active_kernel(bool narrow = false) {
+        static const Kernel<T> wide = detail::pick_kernel<T>(false);
+        static const Kernel<T> thin = detail::pick_kernel<T>(true);
+        return narrow ? thin : wide;
+    }
+
+    // C[M x N] = A[M x K] * B[K x N] (or += when accumulate), then the epilogue.
+    // C is row-major with leading dim ldc.
+    // Packing buffers are thread_local so concurrent callers never share scratch memory.
+    template<typename T>
+    void gemm(std::size_t M, std::size_t N, std::size_t K,
+              MatrixRef<T> A, MatrixRef<T> B, T* C, std::size_t ldc, bool accumulate = false,
+              const Epilogue<T>& epilogue = {}) {
+        if (M == 0 || N == 0) return;
+        if (K == 0) {
+            for (std::size_t i = 0; i < M; ++i) {
+                T* c = C + i * ldc;
+                if (!accumulate) std::fill(c, c + N, T{});
+                if (epilogue.bias)
+                    for (std::size_t j = 0; j < N; ++j) c[j] += epilogue.bias[j];
+            }
+            if (epilogue.finish) epilogue.finish(epilogue.ctx, C, ldc, 0, 0, M, N);
+            return;
+        }
+
+        const Kernel<T>& kernel = active_kernel<T>(N <= 16);
+        const std::size_t mr = kernel.mr, nr = kernel.nr;
+
+        thread_local std::vector<T> a_pack, b_pack;
+        a_pack.resize(MC * KC);
+        b_pack.resize(KC * NC);
+        T tile[MAX_TILE];
+
+        for (std::size_t jc = 0; jc < N; jc += NC) {
+            const std::size_t nc = std::min(NC, N - jc);
+            for (std::size_t pc = 0; pc < K; pc += KC) {
+                const std::size_t kc = std::min(KC, K - pc);
+                const bool acc = accumulate || pc > 0;
+                const bool last = pc + kc == K;
+                const T* bias = last ? epilogue.bias : nullptr;
+                detail::pack_b(kc, nc, MatrixRef<T>{B.at(pc, jc), B.rs, B.cs}, nr, b_pack.data());
+
+                for (std::size_t ic = 0; ic < M; ic += MC) {
+                    const std::size_t mc = std::min(MC, M - ic);
+                    detail::pack_a(mc, kc, MatrixRef<T>{A.at(ic, pc), A.rs, A.cs}, mr, a_pack.data());
+
+                    for (std::size_t jr = 0; jr < nc; jr += nr) {
+                        const std::size_t n = std::min(nr, nc - jr);
+                        const T* bp = b_pack.data() + jr * kc;
+                        const T* bias_jr = bias ? bias + jc + jr : nullptr;
+                        for (std::size_t ir = 0; ir < mc; ir += mr) {
+                            const std::size_t m = std::min(mr, mc - ir);
+                            const T* ap = a_pack.data() + ir * kc;
+                            T* c = C + (ic + ir) * ldc + jc + jr;
+                            if (m == mr && n == nr) {
+                                kernel.run(kc, ap, bp, c, ldc, acc, bias_jr);
+                                continue;
+                            }
+                            // Edge tile: compute into scratch, copy only the valid part
+                            // (bias added here: it has only n valid values)
+                            kernel.run(kc, ap, bp, tile, nr, false, nullptr);
+                            for (std::size_t r = 0; r < m; ++r)
+                                for (std::size_t j = 0; j < n; ++j) {
+                                    T v = acc ? c[r * ldc + j] + tile[r * nr + j] : tile[r * nr + j];
+                                    if (bias_jr) v += bias_jr[j];
+                                    c[r * ldc + j] = v;
+                                }
+                        }
+                        if (last && epilogue.finish)
+                            epilogue.finish(epilogue.ctx, C + ic * ldc + jc + jr, ldc, ic, jc + jr, mc, n);
+                    }
+                }
+            }
+        }
+    }
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_GEMM_H
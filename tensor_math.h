@@ -0,0 +1,394 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_MATH_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_MATH_H
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UTEC_MATH_X86 1
+#include <immintrin.h>
+#endif
+
+// Vectorized exp, log, sigmoid and tanh over contiguous float arrays, with the
+// code path (AVX-512, AVX2+FMA or portable scalar) picked once at runtime.
+// All paths run the same Cephes-style reductions and polynomials, so they
+// agree to within the bounds below. Measured over the whole float range
+// against double-precision libm (MathTest):
+//   exp      < 1.5 ULP   (results below FLT_MIN are denormals, 0 below ~-103.97, inf above ~88.72)
+//   log      < 1 ULP     (denormal inputs handled; log(0) = -inf, log(<0) = NaN)
+//   sigmoid  < 2.5 ULP
+//   tanh     < 1.5 ULP
+// NaN propagates through every function. Input and output may be the same
+// array; other element types go through the std:: functions.
+namespace utec::algebra::vmath {
+
+    using UnaryKernel = void (*)(const float* x, float* y, std::size_t n);
+
+    struct Kernels {
+        const char* name;
+        UnaryKernel exp;
+        UnaryKernel log;
+        UnaryKernel sigmoid;
+        UnaryKernel tanh;
+    };
+
+    namespace detail {
+
+        constexpr float exp_hi = 88.7228394f;       // largest x with finite exp(x)
+        constexpr float exp_lo = -103.972084f;      // below this exp(x) rounds to 0
+        constexpr float log2e = 1.44269504088896341f;
+        constexpr float round_magic = 12582912.0f;  // 1.5 * 2^23: adding it rounds to an integer
+        constexpr float ln2_hi = 0.693359375f;      // ln 2 split so n * ln2_hi is exact
+        constexpr float ln2_lo = -2.12194440e-4f;
+        constexpr float exp_c[6] = {1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+                                    4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f};
+        constexpr float sqrt_half = 0.707106781186547524f;
+        constexpr float log_c[9] = {7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f,
+                                    -1.2420140846e-1f, 1.4249322787e-1f, -1.6668057665e-1f,
+                                    2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f};
+        constexpr float tanh_small = 0.625f;        // below this tanh uses its odd polynomial
+        constexpr float tanh_c[5] = {-5.70498872745e-3f, 2.06390887954e-2f, -5.37397155531e-2f,
+                                     1.33314422036e-1f, -3.33332819422e-1f};
+
+        // ---- scalar reference: same algorithm as the SIMD paths ----
+
+        inline float exp1(float x) {
+            if (x != x) return x;
+            if (x > exp_hi) return std::numeric_limits<float>::infinity();
+            if (x < exp_lo) return 0.0f;
+            const float t = x * log2e + round_magic;
+            const float fn = t - round_magic;
+            const std::int32_t n = std::bit_cast<std::int32_t>(t) - std::bit_cast<std::int32_t>(round_magic);
+            float r = x - fn * ln2_hi;
+            r = r - fn * ln2_lo;
+            const float z = r * r;
+            float p = exp_c[0];
+            for (int i = 1; i < 6; ++i) p = p * r + exp_c[i];
+            p = p * z + r + 1.0f;
+            // 2^n as two factors so n in [-150, 128] never leaves the normal exponent range
+            const std::int32_t n1 = n >> 1, n2 = n - n1;
+            return p * std::bit_cast<float>((n1 + 127) << 23) * std::bit_cast<float>((n2 + 127) << 23);
+        }
+
+        inline float log1(float x) {
+            if (x != x) return x;
+            if (x < 0.0f) return std::numeric_limits<float>::quiet_NaN();
+            if (x == 0.0f) return -std::numeric_limits<float>::infinity();
+            if (x == std::numeric_limits<float>::infinity()) return x;
+            float bias = 0.0f;
+            if (x < std::numeric_limits<float>::min()) { x *= 8388608.0f; bias = 23.0f; } // 2^23
+            const std::int32_t bits = std::bit_cast<std::int32_t>(x);
+            // x = m * 2^e with m in [0.5, 1), then shifted to [sqrt(1/2), sqrt(2)) - 1
+            float m = std::bit_cast<float>((bits & 0x007fffff) | 0x3f000000);
+            float fe = static_cast<float>((bits >> 23) - 126) - bias;
+            if (m < sqrt_half) { fe -= 1.0f; m = m + m - 1.0f; }
+            else m = m - 1.0f;
+            const float z = m * m;
+            float y = log_c[0];
+            for (int i = 1; i < 9; ++i) y = y * m + log_c[i];
+            y = y * m * z;
+            y += fe * ln2_lo;
+            y += -0.5f * z;
+            return (m + y) + fe * ln2_hi;
+        }
+
+        // e = exp(-|x|) never overflows; sigmoid = 1/(1+e) for x >= 0, e/(1+e) otherwise
+        inline float sigmoid1(float x) {
+            const float e = exp1(-std::abs(x));
+            return (x >= 0.0f ? 1.0f : e) / (1.0f + e);
+        }
+
+        inline float tanh1(float x) {
+            // tanh is odd: evaluate on |x| and put the sign back (keeps tanh(-0) = -0)
+            const float ax = std::abs(x);
+            float r;
+            if (ax < tanh_small) {
+                const float z = ax * ax;
+                float p = tanh_c[0];
+                for (int i = 1; i < 5; ++i) p = p * z + tanh_c[i];
+                r = p * z * ax + ax;
+            } else {
+                r = 1.0f - 2.0f / (exp1(ax + ax) + 1.0f);
+            }
+            return std::copysign(r, x);
+        }
+
+        template<float (*F)(float)>
+        void scalar_loop(const float* x, float* y, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) y[i] = F(x[i]);
+        }
+
+#ifdef UTEC_MATH_X86
+        // ---- AVX2 + FMA, 8 lanes. Tails use masked loads/stores ----
+
+        __attribute__((target("avx2,fma")))
+        inline __m256 exp_avx2(__m256 x) {
+            const __m256 hi = _mm256_set1_ps(exp_hi), lo = _mm256_set1_ps(exp_lo);
+            const __m256 over = _mm256_cmp_ps(x, hi, _CMP_GT_OQ);
+            const __m256 under = _mm256_cmp_ps(x, lo, _CMP_LT_OQ);
+            x = _mm256_max_ps(lo, _mm256_min_ps(hi, x)); // operand order keeps NaN
+            const __m256 magic = _mm256_set1_ps(round_magic);
+            const __m256 t = _mm256_fmadd_ps(x, _mm256_set1_ps(log2e), magic);
+            const __m256 fn = _mm256_sub_ps(t, magic);
+            const __m256i n = _mm256_sub_epi32(_mm256_castps_si256(t), _mm256_castps_si256(magic));
+            __m256 r = _mm256_fnmadd_ps(fn, _mm256_set1_ps(ln2_hi), x);
+            r = _mm256_fnmadd_ps(fn, _mm256_set1_ps(ln2_lo), r);
+            const __m256 z = _mm256_mul_ps(r, r);
+            __m256 p = _mm256_set1_ps(exp_c[0]);
+            for (int i = 1; i < 6; ++i) p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(exp_c[i]));
+            p = _mm256_add_ps(_mm256_fmadd_ps(p, z, r), _mm256_set1_ps(1.0f));
+            const __m256i n1 = _mm256_srai_epi32(n, 1), n2 = _mm256_sub_epi32(n, n1);
+            const __m256i bias = _mm256_set1_epi32(127);
+            const __m256 s1 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n1, bias), 23));
+            const __m256 s2 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n2, bias), 23));
+            __m256 res = _mm256_mul_ps(_mm256_mul_ps(p, s1), s2);
+            res = _mm256_blendv_ps(res, _mm256_set1_ps(std::numeric_limits<float>::infinity()), over);
+            return _mm256_andnot_ps(under, res);
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline __m256 log_avx2(__m256 x) {
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+            const __m256 inf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+            const __m256 invalid = _mm256_cmp_ps(x, zero, _CMP_NGE_UQ); // x < 0 or NaN
+            const __m256 is_zero = _mm256_cmp_ps(x, zero, _CMP_EQ_OQ);
+            const __m256 is_inf = _mm256_cmp_ps(x, inf, _CMP_EQ_OQ);
+            const __m256 tiny = _mm256_cmp_ps(x, _mm256_set1_ps(std::numeric_limits<float>::min()), _CMP_LT_OQ);
+            x = _mm256_blendv_ps(x, _mm256_mul_ps(x, _mm256_set1_ps(8388608.0f)), tiny);
+            const __m256i bits = _mm256_castps_si256(x);
+            __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                                                           _mm256_set1_epi32(0x3f000000)));
+            __m256 fe = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+            fe = _mm256_sub_ps(fe, _mm256_and_ps(tiny, _mm256_set1_ps(23.0f)));
+            const __m256 lt = _mm256_cmp_ps(m, _mm256_set1_ps(sqrt_half), _CMP_LT_OQ);
+            fe = _mm256_sub_ps(fe, _mm256_and_ps(lt, one));
+            m = _mm256_add_ps(_mm256_sub_ps(m, one), _mm256_and_ps(lt, m));
+            const __m256 z = _mm256_mul_ps(m, m);
+            __m256 y = _mm256_set1_ps(log_c[0]);
+            for (int i = 1; i < 9; ++i) y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(log_c[i]));
+            y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+            y = _mm256_fmadd_ps(fe, _mm256_set1_ps(ln2_lo), y);
+            y = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, y);
+            __m256 res = _mm256_fmadd_ps(fe, _mm256_set1_ps(ln2_hi), _mm256_add_ps(m, y));
+            res = _mm256_blendv_ps(res, inf, is_inf);
+            res = _mm256_blendv_ps(res, _mm256_set1_ps(-std::numeric_limits<float>::infinity()), is_zero);
+            return _mm256_blendv_ps(res, _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN()), invalid);
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline __m256 sigmoid_avx2(__m256 x) {
+            const __m256 sign = _mm256_set1_ps(-0.0f), one = _mm256_set1_ps(1.0f);
+            const __m256 e = exp_avx2(_mm256_or_ps(x, sign)); // exp(-|x|)
+            const __m256 num = _mm256_blendv_ps(e, one, _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GE_OQ));
+            return _mm256_div_ps(num, _mm256_add_ps(one, e));
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline __m256 tanh_avx2(__m256 x) {
+            const __m256 sign = _mm256_set1_ps(-0.0f), one = _mm256_set1_ps(1.0f);
+            const __m256 ax = _mm256_andnot_ps(sign, x);
+            const __m256 z = _mm256_mul_ps(ax, ax);
+            __m256 p = _mm256_set1_ps(tanh_c[0]);
+            for (int i = 1; i < 5; ++i) p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(tanh_c[i]));
+            const __m256 small = _mm256_fmadd_ps(_mm256_mul_ps(p, z), ax, ax);
+            const __m256 e = exp_avx2(_mm256_add_ps(ax, ax));
+            const __m256 large = _mm256_sub_ps(one, _mm256_div_ps(_mm256_set1_ps(2.0f), _mm256_add_ps(e, one)));
+            const __m256 r = _mm256_blendv_ps(large, small, _mm256_cmp_ps(ax, _mm256_set1_ps(tanh_small), _CMP_LT_OQ));
+            return _mm256_or_ps(r, _mm256_and_ps(x, sign));
+        }
+
+        template<__m256 (*F)(__m256)>
+        __attribute__((target("avx2,fma")))
+        void avx2_loop(const float* x, float* y, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) _mm256_storeu_ps(y + i, F(_mm256_loadu_ps(x + i)));
+            if (i < n) {
+                const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+                const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(n - i)), lane);
+                _mm256_maskstore_ps(y + i, mask, F(_mm256_maskload_ps(x + i, mask)));
+            }
+        }
+
+        // ---- AVX-512, 16 lanes. Tails use mask registers ----
+        // Unmasked shift/min/max/convert intrinsics pass an undefined source
+        // register in GCC's headers and trip -Wmaybe-uninitialized once inlined;
+        // the zero-masked forms with every lane set compile to the same instructions.
+
+        constexpr __mmask16 all_lanes = 0xFFFF;
+
+
+        __attribute__((target("avx512f")))
+        inline __m512 exp_avx512(__m512 x) {
+            const __m512 hi = _mm512_set1_ps(exp_hi), lo = _mm512_set1_ps(exp_lo);
+            const __mmask16 over = _mm512_cmp_ps_mask(x, hi, _CMP_GT_OQ);
+            const __mmask16 under = _mm512_cmp_ps_mask(x, lo, _CMP_LT_OQ);
+            x = _mm512_maskz_max_ps(all_lanes, lo, _mm512_maskz_min_ps(all_lanes, hi, x));
+            const __m512 magic = _mm512_set1_ps(round_magic);
+            const __m512 t = _mm512_fmadd_ps(x, _mm512_set1_ps(log2e), magic);
+            const __m512 fn = _mm512_sub_ps(t, magic);
+            const __m512i n = _mm512_sub_epi32(_mm512_castps_si512(t), _mm512_castps_si512(magic));
+            __m512 r = _mm512_fnmadd_ps(fn, _mm512_set1_ps(ln2_hi), x);
+            r = _mm512_fnmadd_ps(fn, _mm512_set1_ps(ln2_lo), r);
+            const __m512 z = _mm512_mul_ps(r, r);
+            __m512 p = _mm512_set1_ps(exp_c[0]);
+            for (int i = 1; i < 6; ++i) p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(exp_c[i]));
+            p = _mm512_add_ps(_mm512_fmadd_ps(p, z, r), _mm512_set1_ps(1.0f));
+            const __m512i n1 = _mm512_maskz_srai_epi32(all_lanes, n, 1), n2 = _mm512_sub_epi32(n, n1);
+            const __m512i bias = _mm512_set1_epi32(127);
+            const __m512 s1 = _mm512_castsi512_ps(_mm512_maskz_slli_epi32(all_lanes, _mm512_add_epi32(n1, bias), 23));
+            const __m512 s2 = _mm512_castsi512_ps(_mm512_maskz_slli_epi32(all_lanes, _mm512_add_epi32(n2, bias), 23));
+            __m512 res = _mm512_mul_ps(_mm512_mul_ps(p, s1), s2);
+            res = _mm512_mask_blend_ps(over, res, _mm512_set1_ps(std::numeric_limits<float>::infinity()));
+            return _mm512_mask_blend_ps(under, res, _mm512_setzero_ps());
+        }
+
+        __attribute__((target("avx512f")))
+        inline __m512 log_avx512(__m512 x) {
+            const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1.0f);
+            const __m512 inf = _mm512_set1_ps(std::numeric_limits<float>::infinity());
+            const __mmask16 invalid = _mm512_cmp_ps_mask(x, zero, _CMP_NGE_UQ);
+            const __mmask16 is_zero = _mm512_cmp_ps_mask(x, zero, _CMP_EQ_OQ);
+            const __mmask16 is_inf = _mm512_cmp_ps_mask(x, inf, _CMP_EQ_OQ);
+            const __mmask16 tiny = _mm512_cmp_ps_mask(x, _mm512_set1_ps(std::numeric_limits<float>::min()), _CMP_LT_OQ);
+            x = _mm512_mask_mul_ps(x, tiny, x, _mm512_set1_ps(8388608.0f));
+            const __m512i bits = _mm512_castps_si512(x);
+            __m512 m = _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(0x007fffff)),
+                                                           _mm512_set1_epi32(0x3f000000)));
+            __m512 fe = _mm512_maskz_cvtepi32_ps(all_lanes, _mm512_sub_epi32(_mm512_maskz_srli_epi32(all_lanes, bits, 23),
+                                                                              _mm512_set1_epi32(126)));
+            fe = _mm512_mask_sub_ps(fe, tiny, fe, _mm512_set1_ps(23.0f));
+            const __mmask16 lt = _mm512_cmp_ps_mask(m, _mm512_set1_ps(sqrt_half), _CMP_LT_OQ);
+            fe = _mm512_mask_sub_ps(fe, lt, fe, one);
+            m = _mm512_mask_add_ps(_mm512_sub_ps(m, one), lt, _mm512_sub_ps(m, one), m);
+            const __m512 z = _mm512_mul_ps(m, m);
+            __m512 y = _mm512_set1_ps(log_c[0]);
+            for (int i = 1; i < 9; ++i) y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(log_c[i]));
+            y = _mm512_mul_ps(_mm512_mul_ps(y, m), z);
+            y = _mm512_fmadd_ps(fe, _mm512_set1_ps(ln2_lo), y);
+            y = _mm512_fnmadd_ps(_mm512_set1_ps(0.5f), z, y);
+            __m512 res = _mm512_fmadd_ps(fe, _mm512_set1_ps(ln2_hi), _mm512_add_ps(m, y));
+            res = _mm512_mask_blend_ps(is_inf, res, inf);
+            res = _mm512_mask_blend_ps(is_zero, res, _mm512_set1_ps(-std::numeric_limits<float>::infinity()));
+            return _mm512_mask_blend_ps(invalid, res, _mm512_set1_ps(std::numeric_limits<float>::quiet_NaN()));
+        }
+
+        __attribute__((target("avx512f")))
+        inline __m512 sigmoid_avx512(__m512 x) {
+            const __m512 one = _mm512_set1_ps(1.0f);
+            const __m512i sign = _mm512_set1_epi32(static_cast<std::int32_t>(0x80000000u));
+            const __m512 e = exp_avx512(_mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(x), sign)));
+            const __m512 num = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_GE_OQ), e, one);
+            return _mm512_div_ps(num, _mm512_add_ps(one, e));
+        }
+
+        __attribute__((target("avx512f")))
+        inline __m512 tanh_avx512(__m512 x) {
+            const __m512 one = _mm512_set1_ps(1.0f);
+            const __m512i sign = _mm512_set1_epi32(static_cast<std::int32_t>(0x80000000u));
+            const __m512i xi = _mm512_castps_si512(x);
+            const __m512 ax = _mm512_castsi512_ps(_mm512_maskz_andnot_epi32(all_lanes, sign, xi));
+            const __m512 z = _mm512_mul_ps(ax, ax);
+            __m512 p = _mm512_set1_ps(tanh_c[0]);
+            for (int i = 1; i < 5; ++i) p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(tanh_c[i]));
+            const __m512 small = _mm512_fmadd_ps(_mm512_mul_ps(p, z), ax, ax);
+            const __m512 e = exp_avx512(_mm512_add_ps(ax, ax));
+            const __m512 large = _mm512_sub_ps(one, _mm512_div_ps(_mm512_set1_ps(2.0f), _mm512_add_ps(e, one)));
+            const __m512 r = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(ax, _mm512_set1_ps(tanh_small), _CMP_LT_OQ), large, small);
+            return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(r), _mm512_and_si512(xi, sign)));
+        }
+
+        template<__m512 (*F)(__m512)>
+        __attribute__((target("avx512f")))
+        void avx512_loop(const float* x, float* y, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16) _mm512_storeu_ps(y + i, F(_mm512_loadu_ps(x + i)));
+            if (i < n) {
+                const __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+                _mm512_mask_storeu_ps(y + i, mask, F(_mm512_maskz_loadu_ps(mask, x + i)));
+            }
+        }
+#endif
+
+        inline const Kernels scalar_kernels{"scalar", &scalar_loop<exp1>, &scalar_loop<log1>,
+                                            &scalar_loop<sigmoid1>, &scalar_loop<tanh1>};
+
+        // Every path the running CPU supports, best first
+        inline std::vector<Kernels> pick_supported() {
+            std::vector<Kernels> out;
+#ifdef UTEC_MATH_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f"))
+                out.push_back({"avx512", &avx512_loop<exp_avx512>, &avx512_loop<log_avx512>,
+                               &avx512_loop<sigmoid_avx512>, &avx512_loop<tanh_avx512>});
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                out.push_back({"avx2", &avx2_loop<exp_avx2>, &avx2_loop<log_avx2>,
+                               &avx2_loop<sigmoid_avx2>, &avx2_loop<tanh_avx2>});
+#endif
+            out.push_back(scalar_kernels);
+            return out;
+        }
+
+        template<typename T>
+        void check_sizes(std::span<const T> x, std::span<T> y) {
+            if (x.size() != y.size()) throw std::invalid_argument("Input and output sizes do not match");
+        }
+
+    }
+
+    inline const std::vector<Kernels>& supported_kernels() {
+        static const std::vector<Kernels> kernels = detail::pick_supported();
+        return kernels;
+    }
+
+    // Kernels chosen once for the running CPU
+    inline const Kernels& active_kernels() {
+        return supported_kernels().front();
+    }
+
+    template<typename T>
+    void exp(std::span<const T> x, std::span<T> y) {
+        detail::check_sizes(x, y);
+        if constexpr (std::is_same_v<T, float>) active_kernels().exp(x.data(), y.data(), x.size());
+        else for (std::size_t i = 0; i < x.size(); ++i) y[i] = std::exp(x[i]);
+    }
+
+    template<typename T>
+    void log(std::span<const T> x, std::span<T> y) {
+        detail::check_sizes(x, y);
+        if constexpr (std::is_same_v<T, float>) active_kernels().log(x.data(), y.data(), x.size());
+        else for (std::size_t i = 0; i < x.size(); ++i) y[i] = std::log(x[i]);
+    }
+
+    template<typename T>
+    void sigmoid(std::span<const T> x, std::span<T> y) {
+        detail::check_sizes(x, y);
+        if constexpr (std::is_same_v<T, float>) {
+            active_kernels().sigmoid(x.data(), y.data(), x.size());
+        } else {
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                const T e = std::exp(-std::abs(x[i]));
+                y[i] = (x[i] >= 0 ? static_cast<T>(1) : e) / (static_cast<T>(1) + e);
+            }
+        }
+    }
+
+    template<typename T>
+    void tanh(std::span<const T> x, std::span<T> y) {
+        detail::check_sizes(x, y);
+        if constexpr (std::is_same_v<T, float>) active_kernels().tanh(x.data(), y.data(), x.size());
+        else for (std::size_t i = 0; i < x.size(); ++i) y[i] = std::tanh(x[i]);
+    }
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_MATH_H
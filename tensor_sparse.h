@@ -0,0 +1,216 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_SPARSE_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_SPARSE_H
+
+#include "tensor.h"
+#include "tensor_view.h"
+#include <algorithm>
+#include <array>
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace utec::algebra {
+
+    // Compressed Sparse Row matrix: row i owns entries [row_ptr[i], row_ptr[i+1])
+    // of col_idx/values. Meant for bag-of-words inputs where each row has a
+    // handful of nonzeros out of thousands of columns. The arrays use the
+    // tensor allocator, so per-batch matrices are recycled and counted like
+    // tensor storage.
+    template<typename T>
+    class CsrMatrix {
+    public:
+        template<typename U>
+        using Storage = std::vector<U, PooledAllocator<U>>;
+
+    private:
+        std::size_t rows_ = 0;
+        std::size_t cols_ = 0;
+        Storage<std::size_t> row_ptr_{0};
+        Storage<std::uint32_t> col_idx_;
+        Storage<T> values_;
+
+        // Empties out but keeps its capacity, so a reused matrix stops allocating
+        void reset(CsrMatrix& out) const {
+            if (&out == this) throw std::invalid_argument("Output matrix must not alias the source");
+            out.rows_ = 0;
+            out.cols_ = cols_;
+            out.row_ptr_.assign(1, 0);
+            out.col_idx_.clear();
+            out.values_.clear();
+        }
+
+    public:
+        CsrMatrix() = default;
+        explicit CsrMatrix(std::size_t cols) : cols_(cols) {}
+
+        // Appends a row from parallel index/value arrays
+        void push_row(const std::uint32_t* idx, const T* val, std::size_t n) {
+            for (std::size_t p = 0; p < n; ++p)
+                if (idx[p] >= cols_) throw std::out_of_range("Column index out of range for sparse row");
+            col_idx_.insert(col_idx_.end(), idx, idx + n);
+            values_.insert(values_.end(), val, val + n);
+            row_ptr_.push_back(col_idx_.size());
+            ++rows_;
+        }
+
+        void reserve(std::size_t rows, std::size_t nnz) {
+            row_ptr_.reserve(rows + 1);
+            col_idx_.reserve(nnz);
+            values_.reserve(nnz);
+        }
+
+        // Copies rows [begin, end) into out, reusing its storage
+        void row_slice(std::size_t begin, std::size_t end, CsrMatrix& out) const {
+            if (begin > end || end > rows_) throw std::out_of_range("Row slice out of range");
+            reset(out);
+            const std::size_t first = row_ptr_[begin], last = row_ptr_[end];
+            out.rows_ = end - begin;
+            out.row_ptr_.resize(out.rows_ + 1);
+            for (std::size_t i = 0; i <= out.rows_; ++i) out.row_ptr_[i] = row_ptr_[begin + i] - first;
+            out.col_idx_.assign(col_idx_.begin() + first, col_idx_.begin() + last);
+            out.values_.assign(values_.begin() + first, values_.begin() + last);
+        }
+
+        CsrMatrix row_slice(std::size_t begin, std::size_t end) const {
+            CsrMatrix r(cols_);
+            row_slice(begin, end, r);
+            return r;
+        }
+
+        // Copies the rows idx[0..count) in that order (e.g. a shuffled
+        // mini-batch) into out, reusing its storage
+        void gather_rows(const std::size_t* idx, std::size_t count, CsrMatrix& out) const {
+            std::size_t nnz = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (idx[i] >= rows_) throw std::out_of_range("Row index out of range");
+                nnz += row_ptr_[idx[i] + 1] - row_ptr_[idx[i]];
+            }
+            reset(out);
+            out.reserve(count, nnz);
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::size_t first = row_ptr_[idx[i]], last = row_ptr_[idx[i] + 1];
+                out.col_idx_.insert(out.col_idx_.end(), col_idx_.begin() + first, col_idx_.begin() + last);
+                out.values_.insert(out.values_.end(), values_.begin() + first, values_.begin() + last);
+                out.row_ptr_.push_back(out.col_idx_.size());
+            }
+            out.rows_ = count;
+        }
+
+        CsrMatrix gather_rows(const std::size_t* idx, std::size_t count) const {
+            CsrMatrix r(cols_);
+            gather_rows(idx, count, r);
+            return r;
+        }
+
+        std::array<std::size_t, 2> shape() const noexcept { return {rows_, cols_}; }
+        std::size_t nnz() const noexcept { return values_.size(); }
+        const Storage<std::size_t>& row_ptr() const noexcept { return row_ptr_; }
+        const Storage<std::uint32_t>& col_idx() const noexcept { return col_idx_; }
+        const Storage<T>& values() const noexcept { return values_; }
+
+        Tensor<T, 2> to_dense() const {
+            Tensor<T, 2> d(rows_, cols_);
+            auto out = d.begin();
+            for (std::size_t i = 0; i < rows_; ++i)
+                for (std::size_t p = row_ptr_[i]; p < row_ptr_[i + 1]; ++p)
+                    out[i * cols_ + col_idx_[p]] += values_[p];
+            return d;
+        }
+    };
+
+    // C = A * B with A sparse (M x K) and B dense (K x N): each nonzero scales one row of B.
+    // C is resized in place, so a reused output keeps its storage. The epilogue
+    // works as in gemm: bias and activation are applied while each row block is hot
+    template<typename T>
+    void sparse_dense_product(const CsrMatrix<T>& A, std::type_identity_t<TensorView<T>> B, Tensor<T, 2>& C,
+                              const gemm::Epilogue<T>& epilogue = {}) {
+        const auto [M, K] = A.shape();
+        const std::size_t N = B.shape()[1];
+        if (K != B.shape()[0]) throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+
+        C.reshape(M, N);
+        T* c = C.span().data();
+        const auto b = B.cbegin();
+        const auto& rp = A.row_ptr();
+        const auto& ci = A.col_idx();
+        const auto& v = A.values();
+        // Rows start from the bias; finish gets blocks of MC finished rows
+        // while they are still in cache
+        for (std::size_t i0 = 0; i0 < M; i0 += gemm::MC) {
+            const std::size_t rows = std::min(gemm::MC, M - i0);
+            for (std::size_t i = i0; i < i0 + rows; ++i) {
+                T* ci_row = c + i * N;
+                if (epilogue.bias) std::copy(epilogue.bias, epilogue.bias + N, ci_row);
+                else std::fill(ci_row, ci_row + N, T{});
+                for (std::size_t p = rp[i]; p < rp[i + 1]; ++p) {
+                    const T a = v[p];
+                    const auto b_row = b + ci[p] * N;
+                    for (std::size_t j = 0; j < N; ++j) ci_row[j] += a * b_row[j];
+                }
+            }
+            if (epilogue.finish) epilogue.finish(epilogue.ctx, c + i0 * N, N, i0, 0, rows, N);
+        }
+    }
+
+    template<typename T>
+    Tensor<T, 2> sparse_dense_product(const CsrMatrix<T>& A, const Tensor<T, 2>& B) {
+        Tensor<T, 2> C;
+        sparse_dense_product(A, B, C);
+        return C;
+    }
+
+    // C = A^T * B with A sparse (M x K) and B dense (M x N), written to
+    // caller-owned memory of K * N elements (e.g. a slice of a gradient arena).
+    // Only the rows of C named in A.col_idx() are zeroed and accumulated, so the
+    // cost follows nnz * N instead of K * N. The other rows are left as they
+    // are: the caller keeps them zero (Dense clears the previous batch's rows)
+    template<typename T>
+    void sparse_transpose_product(const CsrMatrix<T>& A, std::type_identity_t<TensorView<T>> B, std::span<T> C) {
+        const auto [M, K] = A.shape();
+        const std::size_t N = B.shape()[1];
+        if (M != B.shape()[0]) throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        if (C.size() != K * N) throw std::invalid_argument("Output span does not match the product shape");
+        const bool b_in_c = B.size() && B.data() >= C.data() && B.data() < C.data() + C.size();
+        if (b_in_c) throw std::invalid_argument("Output tensor must not alias an operand");
+
+        T* c = C.data();
+        const T* b = B.data();
+        const auto& rp = A.row_ptr();
+        const auto& ci = A.col_idx();
+        const auto& v = A.values();
+        for (const std::uint32_t k : ci) std::fill_n(c + k * N, N, T{});
+        for (std::size_t i = 0; i < M; ++i) {
+            const T* b_row = b + i * N;
+            for (std::size_t p = rp[i]; p < rp[i + 1]; ++p) {
+                const T a = v[p];
+                T* c_row = c + ci[p] * N;
+                for (std::size_t j = 0; j < N; ++j) c_row[j] += a * b_row[j];
+            }
+        }
+    }
+
+    // Same product into a Tensor, resized in place so a reused output keeps its
+    // storage. Here C holds nothing else, so it is cleared first
+    template<typename T>
+    void sparse_transpose_product(const CsrMatrix<T>& A, const Tensor<T, 2>& B, Tensor<T, 2>& C) {
+        if (&B == &C) throw std::invalid_argument("Output tensor must not alias an operand");
+        C.reshape(A.shape()[1], B.shape()[1]);
+        C.fill(T{});
+        sparse_transpose_product<T>(A, B, C.span());
+    }
+
+    template<typename T>
+    Tensor<T, 2> sparse_transpose_product(const CsrMatrix<T>& A, const Tensor<T, 2>& B) {
+        Tensor<T, 2> C;
+        sparse_transpose_product(A, B, C);
+        return C;
+    }
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_SPARSE_H
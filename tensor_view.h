@@ -0,0 +1,110 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_VIEW_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_VIEW_H
+
+#include "tensor.h"
+#include <array>
+#include <span>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace utec::algebra {
+
+    // Non-owning, read-only view of a contiguous block of rows of a row-major
+    // matrix (typically a Tensor<T, 2>). Slicing rows is pointer arithmetic,
+    // so mini-batches never copy the dataset. The viewed tensor must outlive
+    // the view and must not be resized while the view is in use.
+    template<typename T>
+    class TensorView {
+        const T* data_ = nullptr;
+        std::size_t rows_ = 0;
+        std::size_t cols_ = 0;
+
+    public:
+        TensorView() = default;
+        TensorView(const T* data, std::size_t rows, std::size_t cols)
+            : data_(data), rows_(rows), cols_(cols) {}
+
+        // Implicit: any Tensor<T, 2> can be passed where a view is expected
+        TensorView(const Tensor<T, 2>& t)
+            : data_(t.span().data()), rows_(t.shape()[0]), cols_(t.shape()[1]) {}
+
+        TensorView(const Tensor<T, 2>& t, std::size_t row_begin, std::size_t row_count)
+            : TensorView(TensorView(t).rows(row_begin, row_count)) {}
+
+        TensorView rows(std::size_t begin, std::size_t count) const {
+            if (begin + count > rows_) throw std::out_of_range("Row range out of view bounds");
+            return {data_ + begin * cols_, count, cols_};
+        }
+
+        std::array<std::size_t, 2> shape() const noexcept { return {rows_, cols_}; }
+        std::size_t size() const noexcept { return rows_ * cols_; }
+        const T* data() const noexcept { return data_; }
+        const T* cbegin() const noexcept { return data_; }
+        const T* cend() const noexcept { return data_ + size(); }
+
+        const T& operator()(std::size_t i, std::size_t j) const { return data_[i * cols_ + j]; }
+        std::span<const T> row(std::size_t i) const { return {data_ + i * cols_, cols_}; }
+
+        // Copies into out, reusing its storage when the capacity fits
+        void copy_to(Tensor<T, 2>& out) const {
+            out.reshape(rows_, cols_);
+            std::copy(cbegin(), cend(), out.begin());
+        }
+
+        Tensor<T, 2> to_tensor() const {
+            Tensor<T, 2> out(rows_, cols_);
+            std::copy(cbegin(), cend(), out.begin());
+            return out;
+        }
+    };
+
+    // C = A * B with A given as a view (e.g. a mini-batch of rows); B may be a
+    // Tensor<T, 2> or a view over external memory (e.g. mapped weights).
+    // The epilogue (bias, activation) runs inside the GEMM's store phase
+    template<typename T>
+    void matrix_product(TensorView<T> A, std::type_identity_t<TensorView<T>> B, Tensor<T, 2>& C,
+                        const gemm::Epilogue<T>& epilogue = {}) {
+        const auto [M, K] = A.shape();
+        const std::size_t N = B.shape()[1];
+        if (K != B.shape()[0]) throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        const T* c = C.span().data();
+        const bool a_in_c = C.size() && A.data() >= c && A.data() < c + C.size();
+        if (a_in_c || (C.size() && c == B.data()))
+            throw std::invalid_argument("Output tensor must not alias an operand");
+        C.reshape(M, N);
+        gemm::gemm<T>(M, N, K, {A.data(), K, 1}, {B.data(), N, 1}, C.span().data(), N, false, epilogue);
+    }
+
+    // C = Aᵀ * B with A (K x M) and B (K x N) given as views, written to
+    // caller-owned memory of M * N elements (e.g. a slice of a gradient arena)
+    template<typename T>
+    void matmul_tn(TensorView<T> A, std::type_identity_t<TensorView<T>> B, std::span<T> C) {
+        const auto [K, M] = A.shape();
+        const std::size_t N = B.shape()[1];
+        if (K != B.shape()[0]) throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        if (C.size() != M * N) throw std::invalid_argument("Output span does not match the product shape");
+        gemm::gemm<T>(M, N, K, {A.data(), 1, M}, {B.data(), N, 1}, C.data(), N);
+    }
+
+    // C = A * Bᵀ with A (M x K) and B (N x K) given as views; B may live in external memory
+    template<typename T>
+    void matmul_nt(TensorView<T> A, std::type_identity_t<TensorView<T>> B, Tensor<T, 2>& C) {
+        const auto [M, K] = A.shape();
+        const std::size_t N = B.shape()[0];
+        if (K != B.shape()[1]) throw std::invalid_argument("Matrix dimensions are incompatible for multiplication");
+        const T* c = C.span().data();
+        const bool a_in_c = C.size() && A.data() >= c && A.data() < c + C.size();
+        if (a_in_c || (C.size() && c == B.data()))
+            throw std::invalid_argument("Output tensor must not alias an operand");
+        C.reshape(M, N);
+        gemm::gemm<T>(M, N, K, {A.data(), K, 1}, {B.data(), 1, K}, C.span().data(), N);
+    }
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_TENSOR_VIEW_H
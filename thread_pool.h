@@ -0,0 +1,119 @@
+//
+// Created by paulo on 17/10/2026.
+//
+
+#ifndef PROG3_NN_FINAL_PROJECT_V2025_01_THREAD_POOL_H
+#define PROG3_NN_FINAL_PROJECT_V2025_01_THREAD_POOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+namespace utec::parallel {
+
+    // Pool fijo de hilos para paralelismo fork-join: parallel_for reparte las
+    // tareas [0, n) entre los workers y el hilo que llama, y retorna cuando
+    // todas terminaron. Si alguna lanza, la primera excepción se relanza.
+    // Un solo parallel_for a la vez por pool
+    class ThreadPool {
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+
+        // Job actual: la función de parallel_for por referencia y cómo llamarla
+        void (*call_)(void*, std::size_t) = nullptr;
+        void* job_ = nullptr;
+        std::size_t next_ = 0;
+        std::size_t total_ = 0;
+        std::size_t pending_ = 0;
+        std::size_t generation_ = 0;
+        bool stop_ = false;
+        std::exception_ptr error_;
+
+        // Toma tareas del job actual hasta agotarlas; se llama con el lock tomado
+        void drain(std::unique_lock<std::mutex>& lock) {
+            while (job_ && next_ < total_) {
+                const std::size_t task = next_++;
+                const auto call = call_;
+                void* job = job_;
+                lock.unlock();
+                std::exception_ptr error;
+                try {
+                    call(job, task);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                lock.lock();
+                if (error && !error_) error_ = error;
+                if (--pending_ == 0) done_.notify_all();
+            }
+        }
+
+        void worker_loop() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            std::size_t seen = 0;
+            while (true) {
+                wake_.wait(lock, [&] { return stop_ || (generation_ != seen && job_ && next_ < total_); });
+                if (stop_) return;
+                seen = generation_;
+                drain(lock);
+            }
+        }
+
+    public:
+        // threads = hilos totales, contando al que llama a parallel_for
+        explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency()) {
+            if (threads == 0) threads = 1;
+            for (std::size_t i = 1; i < threads; ++i)
+                workers_.emplace_back([this] { worker_loop(); });
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (auto& w : workers_) w.join();
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::size_t size() const noexcept { return workers_.size() + 1; }
+
+        // fn se usa por referencia, sin envolverla en std::function: repartir
+        // un job no reserva memoria
+        template<typename F>
+        void parallel_for(std::size_t n, F&& fn) {
+            if (n == 0) return;
+            if (workers_.empty() || n == 1) {
+                for (std::size_t i = 0; i < n; ++i) fn(i);
+                return;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            call_ = [](void* job, std::size_t task) { (*static_cast<std::remove_reference_t<F>*>(job))(task); };
+            job_ = const_cast<void*>(static_cast<const void*>(std::addressof(fn)));
+            next_ = 0;
+            total_ = pending_ = n;
+            error_ = nullptr;
+            ++generation_;
+            wake_.notify_all();
+
+            drain(lock);
+            done_.wait(lock, [&] { return pending_ == 0; });
+            job_ = nullptr;
+            if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    };
+
+}
+
+#endif //PROG3_NN_FINAL_PROJECT_V2025_01_THREAD_POOL_H